@@ -0,0 +1,64 @@
+/*
+ * AutoTune.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_AUTOTUNE_H_
+#define INC_AUTOTUNE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum {
+    AUTOTUNE_IDLE = 0,
+    AUTOTUNE_RUNNING = 1,
+    AUTOTUNE_DONE = 2,
+    AUTOTUNE_FAILED = 3
+} AutoTune_State_t;
+
+/**
+ * @brief Ket qua relay test va gain Ziegler-Nichols (don vi register x100)
+ */
+typedef struct {
+    uint16_t ku;            /**< Gain toi han (0.01 output / RPM) */
+    uint16_t tu_ms;         /**< Chu ky toi han (ms) */
+    uint16_t kp;
+    uint16_t ki;
+    uint16_t kd;
+} AutoTune_Result_t;
+
+/**
+ * @brief Bat dau relay test (Astrom-Hagglund) cho vong toc do
+ *
+ * Output = bias +/- amplitude, doi chieu khi toc do vuot setpoint +/- hysteresis.
+ * Bo qua CONFIG_AUTOTUNE_SKIP_CYCLES chu ky dau, lay trung binh chu ky va bien do
+ * dao dong tren CONFIG_AUTOTUNE_CYCLES chu ky tiep theo.
+ * Don vi output theo mode: duty permille (PID) hoac mA (CASCADE); amplitude,
+ * bias, out_min/out_max cung don vi voi gia tri tra ve cua AutoTune_Step().
+ */
+void AutoTune_Start(uint8_t motor, int32_t setpoint, int32_t bias, int32_t amplitude,
+                    int32_t hysteresis, int32_t out_min, int32_t out_max);
+
+void AutoTune_Abort(uint8_t motor);
+
+/**
+ * @brief Mot chu ky dieu khien (1 kHz, task)
+ * @return Output relay (cung don vi voi amplitude)
+ */
+int32_t AutoTune_Step(uint8_t motor, int32_t speed);
+
+AutoTune_State_t AutoTune_GetState(uint8_t motor);
+
+/**
+ * @brief Tien do 0-100 %
+ */
+uint16_t AutoTune_GetProgress(uint8_t motor);
+
+/**
+ * @brief Ket qua, hop le khi state = AUTOTUNE_DONE
+ */
+bool AutoTune_GetResult(uint8_t motor, AutoTune_Result_t *out);
+
+#endif /* INC_AUTOTUNE_H_ */
@@ -0,0 +1,54 @@
+/*
+ * BackEMF.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_BACKEMF_H_
+#define INC_BACKEMF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Thong so mo hinh dong co DC (don vi register)
+ */
+typedef struct {
+    uint16_t r_mohm;            /**< Dien tro phan ung (mOhm) */
+    uint16_t l_uh;              /**< Dien cam phan ung (uH) */
+    uint16_t ke_uv_per_rpm;     /**< Hang so suc phan dien (uV / RPM), 0 = tat */
+    uint16_t vbus_mv;           /**< Dien ap nguon cau H (mV) */
+} BackEMF_Params_t;
+
+/**
+ * @brief Nap thong so, quy doi sang he so Q16 theo tan so vong nhanh
+ *
+ * Goi tu task moi chu ky dieu khien; khong lam gi neu thong so khong doi.
+ * Moi phep chia nam o day, BackEMF_Update() chi nhan/dich.
+ */
+void BackEMF_Configure(uint8_t motor, const BackEMF_Params_t *params, uint32_t loop_hz);
+
+bool BackEMF_IsEnabled(uint8_t motor);
+
+/**
+ * @brief Mot buoc uoc luong, goi trong ISR CurrentSense moi tick nhanh
+ *
+ * Ke*w = V - I*R - L*dI/dt, V = duty * Vbus (duty cua chu ky vua do dong).
+ * Toc do qua loc thong thap bac 1 (CONFIG_BACKEMF_FILTER_SHIFT).
+ * @param duty Duty dang xuat (Q15, co dau)
+ * @param current_ma Dong motor (mA), cung dau voi duty khi keo tai
+ */
+void BackEMF_Update(uint8_t motor, int32_t duty, int32_t current_ma);
+
+/**
+ * @brief Xoa trang thai khi cau H khong dan (dien ap dau cuc khong xac dinh)
+ */
+void BackEMF_Reset(uint8_t motor);
+
+/**
+ * @brief Toc do uoc luong moi nhat (RPM)
+ */
+int32_t BackEMF_GetSpeed(uint8_t motor);
+
+#endif /* INC_BACKEMF_H_ */
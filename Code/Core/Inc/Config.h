@@ -8,6 +8,123 @@
 #ifndef INC_CONFIG_H_
 #define INC_CONFIG_H_
 
+/* ---------------------------------------------------------------------------
+ * System clock profile
+ * ---------------------------------------------------------------------------
+ * 72MHZ_HSE: 8 MHz crystal x9, needs the HSE populated on PD0/PD1.
+ * 64MHZ_HSI: HSI/2 x16, no crystal needed (max PLL output from HSI).
+ * SystemClock_Config() (generated from Driver.ioc) always starts on the
+ * 64 MHz HSI profile; Timing_SelectClockProfile() then moves the PLL to the
+ * HSE when the 72 MHz profile is selected and stays on HSI if the HSE does
+ * not start. All timer and UART timing is derived from the clock actually
+ * running (see Timing.c).
+ */
+#define CONFIG_SYSCLK_PROFILE_64MHZ_HSI   0
+#define CONFIG_SYSCLK_PROFILE_72MHZ_HSE   1
+
+#ifndef CONFIG_SYSCLK_PROFILE
+#define CONFIG_SYSCLK_PROFILE             CONFIG_SYSCLK_PROFILE_72MHZ_HSE
+#endif
+
+/* ---------------------------------------------------------------------------
+ * Timing targets
+ * ---------------------------------------------------------------------------
+ */
+#define CONFIG_PWM_FREQUENCY_HZ           20000U  /**< Default PWM switching frequency */
+#define CONFIG_CURRENT_LOOP_HZ            5000U   /**< Fast loop rate (current sampling / control) */
+#define CONFIG_CONTROL_LOOP_HZ            1000U   /**< Speed loop rate, one RTOS tick */
+#define CONFIG_MODBUS_BAUDRATE            9600U   /**< RS485 baudrate on USART2 */
+
+/* ---------------------------------------------------------------------------
+ * PWM / H-bridge
+ * ---------------------------------------------------------------------------
+ * Motor 1: TIM3 CH3 (PWM1, PB0), direction DIR1/DIR2
+ * Motor 2: TIM1 CH1 (PWM3, PA8), direction DIR3/DIR4
+ */
+#define MOTOR_COUNT                       2U
+#define CONFIG_PWM_FREQUENCY_MIN_HZ       1000U
+#define CONFIG_PWM_FREQUENCY_MAX_HZ       100000U
+
+/* ---------------------------------------------------------------------------
+ * Current sensing (ACS712, bidirectional, zero at Vcc/2)
+ * ---------------------------------------------------------------------------
+ * This board revision routes a single ACS712 to PA0 (CUR_SENS) in the bridge
+ * supply, so both motors sample ADC channel 0 until a second sensor is fitted.
+ */
+#define CONFIG_CURRENT_M1_ADC_CHANNEL     0U      /**< ADC1_IN0, PA0 */
+#define CONFIG_CURRENT_M2_ADC_CHANNEL     0U      /**< ADC1_IN0, PA0 (shared) */
+#define CONFIG_ACS712_MV_PER_A            185U    /**< ACS712-05B sensitivity */
+#define CONFIG_ADC_VREF_MV                3300U
+#define CONFIG_CURRENT_OVERSAMPLE_MAX     32U     /**< Max PWM periods summed per fast loop tick */
+
+/* ---------------------------------------------------------------------------
+ * H-bridge thermal rating (Thermal.h), per bridge
+ * ---------------------------------------------------------------------------
+ * The I2t model lets the bridge run above the continuous rating until its
+ * modeled temperature reaches the rated steady state, and never above peak.
+ */
+#define CONFIG_BRIDGE_RATED_MA            3000U   /**< Continuous current */
+#define CONFIG_BRIDGE_PEAK_MA             5000U   /**< Absolute current ceiling */
+#define CONFIG_BRIDGE_TAU_MS              20000U  /**< Thermal time constant */
+
+/* ---------------------------------------------------------------------------
+ * Speed feedback: quadrature encoder on IN1-IN4 (Encoder.h), otherwise the
+ * back-EMF estimator (BackEMF.h) when Ke is configured
+ * ---------------------------------------------------------------------------
+ */
+#define CONFIG_ENCODER_TIMEOUT_MS         100U    /**< No edge for this long -> speed = 0 */
+#define CONFIG_BACKEMF_FILTER_SHIFT       4U      /**< Sensorless speed LPF, tau = 2^n fast ticks */
 
+/* ---------------------------------------------------------------------------
+ * Relay auto-tune (AutoTune.h)
+ * ---------------------------------------------------------------------------
+ */
+#define CONFIG_AUTOTUNE_SKIP_CYCLES       2U      /**< Settling cycles ignored */
+#define CONFIG_AUTOTUNE_CYCLES            4U      /**< Cycles averaged for Ku / Tu */
+#define CONFIG_AUTOTUNE_TIMEOUT_MS        20000U
+
+/* ---------------------------------------------------------------------------
+ * Motor parameter identification (MotorIdent.h)
+ * ---------------------------------------------------------------------------
+ * Step for STEP_MS, then duty ramps to 2x step and back over 2 x RAMP_MS.
+ * SLOW_SAMPLES must cover (STEP_MS + 2 * RAMP_MS) / DECIMATION.
+ */
+#define CONFIG_IDENT_STEP_MS              300U
+#define CONFIG_IDENT_RAMP_MS              300U
+#define CONFIG_IDENT_DECIMATION           2U      /**< Control ticks per recorded sample */
+#define CONFIG_IDENT_SLOW_SAMPLES         512U
+#define CONFIG_IDENT_FAST_SAMPLES         128U    /**< Fast-loop current samples at step start */
+
+/* ---------------------------------------------------------------------------
+ * Controlled stop (REG_Mx_STOP_MODE = DECEL)
+ * ---------------------------------------------------------------------------
+ * Once the speed reference reaches 0 the bridge is released when the measured
+ * speed is below STOP_SPEED_RPM, or after STOP_TIMEOUT_MS at the latest.
+ */
+#define CONFIG_STOP_SPEED_RPM             5U
+#define CONFIG_STOP_TIMEOUT_MS            500U
+
+/* ---------------------------------------------------------------------------
+ * Stall detection (Stall.h)
+ * ---------------------------------------------------------------------------
+ * Auto-retry waits retry_delay << n before retry n (n capped at BACKOFF_SHIFT)
+ * and forgets past retries after running stall-free for RETRY_RESET_MS.
+ */
+#define CONFIG_STALL_BACKOFF_SHIFT        4U      /**< Max doubling of the retry delay */
+#define CONFIG_STALL_RETRY_RESET_MS       2000U
+
+/* ---------------------------------------------------------------------------
+ * Motion segment queue (MotionQueue.h)
+ * ---------------------------------------------------------------------------
+ */
+#define CONFIG_MOTION_QUEUE_DEPTH         16U     /**< Segments buffered per motor */
+
+/* ---------------------------------------------------------------------------
+ * Parameter storage (Storage.h)
+ * ---------------------------------------------------------------------------
+ * Last 1 KB flash page of the STM32F103C8, excluded from FLASH in the linker
+ * script.
+ */
+#define CONFIG_STORAGE_FLASH_ADDR         0x0800FC00UL
 
 #endif /* INC_CONFIG_H_ */
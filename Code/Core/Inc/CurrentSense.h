@@ -0,0 +1,74 @@
+/*
+ * CurrentSense.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_CURRENTSENSE_H_
+#define INC_CURRENTSENSE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "Config.h"
+
+/**
+ * @brief Ket qua mot tick vong lap nhanh (sau oversampling/decimation)
+ */
+typedef struct {
+    int16_t  current_ma[MOTOR_COUNT];   /**< Dong motor (mA), co dau */
+    uint16_t raw[MOTOR_COUNT];          /**< Gia tri ADC trung binh (0-4095) */
+    uint32_t tick;                      /**< So thu tu tick vong lap nhanh */
+} CurrentSense_Sample_t;
+
+/**
+ * @brief Khoi tao ADC1 scan + DMA1 Channel1 circular
+ *
+ * ADC duoc trigger boi TIM1_CC2 (PWM.c dat CCR2 o giua thoi gian dan).
+ * Moi nua buffer DMA chua N lan scan (N = PWM / CONFIG_CURRENT_LOOP_HZ),
+ * ngat HT/TC cong N mau va publish mot gia tri moi o tan so vong lap nhanh.
+ * Goi sau PWM_Init(), khi motor con tat (hieu chinh offset zero).
+ */
+void CurrentSense_Init(void);
+
+/**
+ * @brief Tinh lai he so decimation sau khi doi tan so PWM
+ */
+void CurrentSense_Reconfigure(void);
+
+/**
+ * @brief Dong dien moi nhat cua motor (mA) - O(1), khong khoa
+ */
+int16_t CurrentSense_GetMilliAmps(uint8_t motor);
+
+/**
+ * @brief Snapshot dong bo cua ca hai kenh (seqlock, khong tat ngat)
+ */
+void CurrentSense_GetSample(CurrentSense_Sample_t *sample);
+
+/**
+ * @brief Doi dong dien (mA, co dau) sang gia tri ADC tho cua kenh, tinh ca offset zero
+ */
+uint16_t CurrentSense_MilliAmpsToRaw(uint8_t motor, int32_t ma);
+
+/**
+ * @brief Tan so vong lap nhanh hien tai (Hz)
+ */
+uint32_t CurrentSense_GetLoopHz(void);
+
+/**
+ * @brief true khi da hieu chinh xong offset zero
+ */
+bool CurrentSense_IsReady(void);
+
+/**
+ * @brief Xu ly ngat DMA1 Channel1 (goi tu DMA1_Channel1_IRQHandler)
+ */
+void CurrentSense_IRQHandler(void);
+
+/**
+ * @brief Goi trong ngat sau moi mau moi (weak, override o module dieu khien)
+ */
+void CurrentSense_SampleCallback(void);
+
+#endif /* INC_CURRENTSENSE_H_ */
@@ -0,0 +1,66 @@
+/*
+ * DiffDrive.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_DIFFDRIVE_H_
+#define INC_DIFFDRIVE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Thong so robot vi sai (banh trai = Motor 1, banh phai = Motor 2)
+ */
+typedef struct {
+    uint16_t wheel_base_mm;     /**< Khoang cach 2 banh */
+    uint16_t wheel_radius;      /**< Ban kinh banh (0.01 mm) */
+    uint16_t max_wheel_rpm;     /**< Gioi han toc do banh, 0 = INT16_MAX */
+    uint16_t accel;             /**< Doc v (mm/s^2), 0 = khong doc */
+    uint16_t alpha;             /**< Doc w (mrad/s^2), 0 = khong doc */
+} DiffDrive_Params_t;
+
+/**
+ * @brief Phan hoi mot banh, da doi dau theo chieu lap (tien = duong)
+ */
+typedef struct {
+    int32_t  rpm;
+    int32_t  position;          /**< Xung x4 (khi co encoder) */
+    uint32_t counts_per_rev;    /**< 0 = khong encoder, odometry theo toc do */
+} DiffDrive_Wheel_t;
+
+typedef struct {
+    int32_t x_mm;
+    int32_t y_mm;
+    int16_t theta_mrad;         /**< [-pi, pi) */
+    int16_t v_mm_s;             /**< Van toc do duoc */
+    int16_t w_mrad_s;
+} DiffDrive_Odometry_t;
+
+/**
+ * @brief Mot tick dong hoc: doc v/w -> toc do 2 banh (cung mot cap v/w),
+ *        tich phan odometry
+ *
+ * Goi tu ca hai task motor; chi lan goi dau tien cua moi tick RTOS tinh
+ * (khoa scheduler), lan sau dung lai ket qua nen 2 banh luon cung tick.
+ * Vuot max_wheel_rpm: chia ca hai banh cung ti le -> giu nguyen do cong v/w.
+ */
+void    DiffDrive_Update(uint32_t tick, const DiffDrive_Params_t *params, int32_t v_mm_s,
+                         int32_t w_mrad_s, const DiffDrive_Wheel_t wheels[2], uint32_t loop_hz);
+
+/**
+ * @brief Toc do dat banh (RPM, tien = duong) cua tick hien tai
+ */
+int32_t DiffDrive_GetWheelRpm(uint8_t wheel);
+bool    DiffDrive_IsSaturated(void);
+
+/**
+ * @brief Dat lai tham chieu doc v/w (vd. khi bat motor)
+ */
+void    DiffDrive_ResetCommand(void);
+void    DiffDrive_ResetOdometry(void);
+void    DiffDrive_GetOdometry(DiffDrive_Odometry_t *out);
+
+#endif /* INC_DIFFDRIVE_H_ */
@@ -0,0 +1,59 @@
+/*
+ * Encoder.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_ENCODER_H_
+#define INC_ENCODER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Ket qua uoc luong toc do moi chu ky dieu khien
+ */
+typedef struct {
+    int32_t  speed_rpm;     /**< Toc do (RPM), co dau */
+    int32_t  count;         /**< Vi tri tich luy (xung x4) */
+    uint32_t timestamp_ms;  /**< HAL tick luc uoc luong */
+    uint32_t edge_cycles;   /**< DWT CYCCNT cua canh cuoi cung da dung */
+} Encoder_Sample_t;
+
+/**
+ * @brief Khoi tao DWT cycle counter dung lam timestamp canh encoder
+ *
+ * TIM encoder mode khong dung duoc tren IN1-IN4 (TIM3 dang phat PWM1, TIM2
+ * kenh tren PA0/PA1 da dung), nen giai ma x4 bang EXTI:
+ *  Motor 1: A = IN1 (PA5), B = IN2 (PA6)
+ *  Motor 2: A = IN3 (PA7), B = IN4 (PB10)
+ */
+void Encoder_Init(void);
+
+/**
+ * @brief Bat/tat encoder cua motor
+ * @param ppr So xung moi vong mot kenh (0 = khong lap encoder, chan IN la input thuong)
+ */
+void Encoder_Configure(uint8_t motor, uint16_t ppr);
+
+bool Encoder_IsEnabled(uint8_t motor);
+
+/**
+ * @brief Uoc luong M/T, goi moi chu ky dieu khien (task, khong goi trong ISR)
+ *
+ * M/T: toc do = so canh / khoang thoi gian giua canh dau va canh cuoi trong cua
+ * so (do bang CYCCNT), chinh xac ca toc do cao (nhieu canh) lan thap (chu ky
+ * 1 canh). Khong co canh moi: toc do bi chan tren boi 1 canh / thoi gian tu
+ * canh cuoi, ve 0 sau CONFIG_ENCODER_TIMEOUT_MS.
+ */
+void Encoder_Update(uint8_t motor);
+
+void Encoder_GetSample(uint8_t motor, Encoder_Sample_t *out);
+
+/**
+ * @brief Handler EXTI cho IN1-IN4 (chi dem va luu timestamp, khong chia)
+ */
+void Encoder_IRQHandler(void);
+
+#endif /* INC_ENCODER_H_ */
@@ -0,0 +1,84 @@
+/*
+ * FixedPoint.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_FIXEDPOINT_H_
+#define INC_FIXEDPOINT_H_
+
+#include <stdint.h>
+
+/*
+ * Cortex-M3 khong co FPU: moi phep tinh trong vong dieu khien dung so nguyen.
+ * Quy uoc: Qn = gia tri * 2^n, phep nhan trung gian dung int64_t.
+ */
+
+#define FP_Q16_ONE      (1L << 16)
+#define FP_Q24_ONE      (1L << 24)
+
+static inline int32_t FP_Saturate(int64_t value, int32_t min, int32_t max) {
+    if (value > max) {
+        return max;
+    }
+    if (value < min) {
+        return min;
+    }
+    return (int32_t)value;
+}
+
+static inline int32_t FP_Sat32(int64_t value) {
+    return FP_Saturate(value, INT32_MIN, INT32_MAX);
+}
+
+static inline int16_t FP_Sat16(int32_t value) {
+    return (int16_t)FP_Saturate(value, INT16_MIN, INT16_MAX);
+}
+
+// a * b_qn >> n
+static inline int32_t FP_Mul(int32_t a, int32_t b_qn, uint32_t n) {
+    return FP_Sat32(((int64_t)a * b_qn) >> n);
+}
+
+// Can bac hai nguyen (lam tron xuong), tung bit: khong chia, khong bang
+static inline uint32_t FP_Sqrt(uint32_t value) {
+    uint32_t root = 0;
+    uint32_t bit = 1UL << 30;
+
+    while (bit > value) {
+        bit >>= 2;
+    }
+    while (bit != 0U) {
+        if (value >= root + bit) {
+            value -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return root;
+}
+
+/**
+ * @brief value * num / den bieu dien trong Q(shift), bao hoa int32
+ *
+ * Chia truoc roi dich phan du de khong tran int64 khi den lon
+ * (vd. gain / tan so vong lap). Chi dung khi cau hinh, khong dung trong ISR.
+ */
+static inline int32_t FP_RatioQ(int32_t value, uint32_t num, uint32_t den, uint32_t shift) {
+    int64_t t = (int64_t)value * num;
+    int64_t q = t / den;
+    int64_t r = t % den;
+
+    if (q > (INT32_MAX >> shift)) {
+        return INT32_MAX;
+    }
+    if (q < (INT32_MIN >> shift)) {
+        return INT32_MIN;
+    }
+    return FP_Sat32((q << shift) + ((r << shift) / (int64_t)den));
+}
+
+#endif /* INC_FIXEDPOINT_H_ */
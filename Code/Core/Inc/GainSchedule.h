@@ -0,0 +1,50 @@
+/*
+ * GainSchedule.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_GAINSCHEDULE_H_
+#define INC_GAINSCHEDULE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ModbusMap.h"
+#include "PID.h"
+
+/**
+ * @brief Bang gain theo diem moc, noi suy tuyen tinh giua 2 diem ke can
+ *
+ * Gain luu san o don vi PID_t (da quy doi khi cau hinh), 1/dx tinh truoc o Q24
+ * de vong lap chi con nhan va dich. Ngoai bang: giu gain diem dau / cuoi.
+ */
+typedef struct {
+    uint8_t count;                              /**< So diem, 0 = tat / bang loi */
+    uint8_t segment;                            /**< Doan dang dung */
+    int32_t x[GAIN_SCHED_MAX_POINTS];
+    uint32_t inv_dx_q24[GAIN_SCHED_MAX_POINTS - 1U];
+    PID_Gains_t gains[GAIN_SCHED_MAX_POINTS];
+} GainSchedule_t;
+
+/**
+ * @brief Ghi diem moc index thang vao bang (tat bang cho den GainSchedule_Commit)
+ * @param gains Gain tai diem nay (don vi PID_t)
+ */
+void    GainSchedule_SetPoint(GainSchedule_t *sched, uint8_t index, int32_t x, const PID_Gains_t *gains);
+
+/**
+ * @brief Kiem tra count diem da ghi, tinh 1/dx va bat bang
+ * @return false neu count ngoai 2..GAIN_SCHED_MAX_POINTS hoac x khong tang -> bang tat
+ */
+bool    GainSchedule_Commit(GainSchedule_t *sched, uint8_t count);
+void    GainSchedule_Disable(GainSchedule_t *sched);
+bool    GainSchedule_IsEnabled(const GainSchedule_t *sched);
+
+/**
+ * @brief Noi suy gain tai x (mot lan moi chu ky dieu khien)
+ * @return Chi so doan [point i, point i+1] chua x
+ */
+uint8_t GainSchedule_Evaluate(GainSchedule_t *sched, int32_t x, PID_Gains_t *out);
+
+#endif /* INC_GAINSCHEDULE_H_ */
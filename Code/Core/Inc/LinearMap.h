@@ -0,0 +1,34 @@
+/*
+ * LinearMap.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_LINEARMAP_H_
+#define INC_LINEARMAP_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ModbusMap.h"
+
+/**
+ * @brief Nap bang input -> duty cho mode LINEAR
+ *
+ * Bu vung chet tinh san vao bang (Q15): duty = deadband + point * (1 - deadband).
+ * @param points   LINEAR_LUT_POINTS gia tri phan nghin, khong giam, <= 1000
+ * @param deadband Duty bat dau quay (phan nghin)
+ * @return false neu bang khong hop le -> tat bang
+ */
+bool    LinearMap_Configure(uint8_t motor, const uint16_t *points, uint16_t deadband);
+void    LinearMap_Disable(uint8_t motor);
+bool    LinearMap_IsEnabled(uint8_t motor);
+
+/**
+ * @brief input (0-1000) -> duty Q15 >= 0, input 0 luon ra 0
+ *
+ * Moc deu: chi so doan = mot phep dich, mot lan noi suy, khong tim kiem.
+ */
+int16_t LinearMap_Lookup(uint8_t motor, uint16_t input);
+
+#endif /* INC_LINEARMAP_H_ */
@@ -42,8 +42,8 @@ typedef enum {
 } eMBRegisterMode;
 
 typedef enum {
-    // Motor 1 Registers (0x0000 - 0x000D)
-    REG_M1_CONTROL_MODE = 0x0000,
+    // Motor 1 Registers (0x0000 - 0x000F)
+    REG_M1_CONTROL_MODE = 0x0000,   // 1=ONOFF, 2=LINEAR, 3=PID, 4=CASCADE
     REG_M1_ONOFF_ENABLE,
     REG_M1_LINEAR_ENABLE,
     REG_M1_PID_ENABLE,
@@ -56,8 +56,10 @@ typedef enum {
     REG_M1_PID_KD,
     REG_M1_STATUS_WORD,
     REG_M1_ERROR_CODE,
+    REG_M1_CURRENT,
+    REG_M1_THERMAL,
 
-    // Motor 2 Registers (0x0010 - 0x001D)
+    // Motor 2 Registers (0x0010 - 0x001F)
     REG_M2_CONTROL_MODE = 0x0010,
     REG_M2_ONOFF_ENABLE,
     REG_M2_LINEAR_ENABLE,
@@ -71,8 +73,10 @@ typedef enum {
     REG_M2_PID_KD,
     REG_M2_STATUS_WORD,
     REG_M2_ERROR_CODE,
+    REG_M2_CURRENT,
+    REG_M2_THERMAL,
 
-    // System Registers (0x0020 - 0x0026) - FIXED: Moved to avoid conflicts
+    // System Registers (0x0020 - 0x002F)
     REG_DEVICE_ID = 0x0020,
     REG_FIRMWARE_VERSION,
     REG_SYSTEM_STATUS,
@@ -80,43 +84,614 @@ typedef enum {
     REG_RESET_ERROR_COMMAND,
     REG_CONFIG_BAUDRATE,
     REG_CONFIG_PARITY,
+    REG_SYSCLK_MHZ,
+    REG_PWM_FREQUENCY_KHZ,
+    REG_PWM_ALIGN_MODE,
+    REG_PWM_RESOLUTION,
+    REG_OCP_THRESHOLD_MA,
+    REG_VBUS_MV,
+    REG_PARAM_SAVE,
+    REG_PWM_OUTPUT_MODE,
+    REG_PWM_DEAD_TIME_NS,
 
-    TOTAL_REG_COUNT  // Use this to size the holding register array
+    // Motor 1 Control Registers (0x0030 - 0x004F)
+    REG_M1_CURRENT_KP = 0x0030,
+    REG_M1_CURRENT_KI,
+    REG_M1_CURRENT_LIMIT,
+    REG_M1_CURRENT_REF,
+    REG_M1_ENCODER_PPR,
+    REG_M1_SPEED_TIMESTAMP,
+    REG_M1_MOTOR_R,
+    REG_M1_MOTOR_L,
+    REG_M1_MOTOR_KE,
+    REG_M1_TUNE_COMMAND,
+    REG_M1_TUNE_STATE,
+    REG_M1_TUNE_PROGRESS,
+    REG_M1_TUNE_AMPLITUDE,
+    REG_M1_TUNE_HYSTERESIS,
+    REG_M1_TUNE_KU,
+    REG_M1_TUNE_TU,
+    REG_M1_MOTOR_J,
+    REG_M1_MOTOR_FV,
+    REG_M1_MOTOR_FC,
+    REG_M1_IDENT_COMMAND,
+    REG_M1_IDENT_STATE,
+    REG_M1_IDENT_DUTY,
+    REG_M1_ACCEL_LIMIT,
+    REG_M1_DECEL_LIMIT,
+    REG_M1_FF_KV,
+    REG_M1_FF_KA,
+    REG_M1_FF_STATIC,
+    REG_M1_STOP_MODE,
+    REG_M1_STOP_DECEL,
+    REG_M1_REGEN_LIMIT,
+    REG_M1_BRAKE_DUTY,
+
+    // Motor 2 Control Registers (0x0050 - 0x006F)
+    REG_M2_CURRENT_KP = 0x0050,
+    REG_M2_CURRENT_KI,
+    REG_M2_CURRENT_LIMIT,
+    REG_M2_CURRENT_REF,
+    REG_M2_ENCODER_PPR,
+    REG_M2_SPEED_TIMESTAMP,
+    REG_M2_MOTOR_R,
+    REG_M2_MOTOR_L,
+    REG_M2_MOTOR_KE,
+    REG_M2_TUNE_COMMAND,
+    REG_M2_TUNE_STATE,
+    REG_M2_TUNE_PROGRESS,
+    REG_M2_TUNE_AMPLITUDE,
+    REG_M2_TUNE_HYSTERESIS,
+    REG_M2_TUNE_KU,
+    REG_M2_TUNE_TU,
+    REG_M2_MOTOR_J,
+    REG_M2_MOTOR_FV,
+    REG_M2_MOTOR_FC,
+    REG_M2_IDENT_COMMAND,
+    REG_M2_IDENT_STATE,
+    REG_M2_IDENT_DUTY,
+    REG_M2_ACCEL_LIMIT,
+    REG_M2_DECEL_LIMIT,
+    REG_M2_FF_KV,
+    REG_M2_FF_KA,
+    REG_M2_FF_STATIC,
+    REG_M2_STOP_MODE,
+    REG_M2_STOP_DECEL,
+    REG_M2_REGEN_LIMIT,
+    REG_M2_BRAKE_DUTY,
+
+    // Motor 1 Gain Schedule (0x0070 - 0x008F)
+    REG_M1_SCHED_SOURCE = 0x0070,
+    REG_M1_SCHED_COUNT,
+    REG_M1_SCHED_ACTIVE,
+    REG_M1_SCHED_TABLE = 0x0074,    // point i: x, Kp, Ki, Kd at +4*i
+
+    // Motor 2 Gain Schedule (0x0090 - 0x00AF)
+    REG_M2_SCHED_SOURCE = 0x0090,
+    REG_M2_SCHED_COUNT,
+    REG_M2_SCHED_ACTIVE,
+    REG_M2_SCHED_TABLE = 0x0094,
+
+    // Motor 1 Motion (0x00B0 - 0x00CF), 32-bit values high word first
+    REG_M1_TARGET_POS_HI = 0x00B0,
+    REG_M1_TARGET_POS_LO,
+    REG_M1_MOVE_VMAX,
+    REG_M1_MOVE_ACCEL,
+    REG_M1_MOVE_COMMAND,
+    REG_M1_POS_KP,
+    REG_M1_IN_POS_WINDOW,
+    REG_M1_POSITION_HI,
+    REG_M1_POSITION_LO,
+    REG_M1_FOLLOWING_ERROR,
+    REG_M1_QUEUE_PUSH,
+    REG_M1_QUEUE_DEPTH,
+    REG_M1_QUEUE_UNDERFLOW,
+    REG_M1_QUEUE_INDEX,
+    REG_M1_QUEUE_OVERFLOW,
+    REG_M1_QUEUE_STAGING = 0x00C0,   // segment i: target hi/lo, vmax, accel at +4*i
+
+    // Motor 2 Motion (0x00D0 - 0x00EF)
+    REG_M2_TARGET_POS_HI = 0x00D0,
+    REG_M2_TARGET_POS_LO,
+    REG_M2_MOVE_VMAX,
+    REG_M2_MOVE_ACCEL,
+    REG_M2_MOVE_COMMAND,
+    REG_M2_POS_KP,
+    REG_M2_IN_POS_WINDOW,
+    REG_M2_POSITION_HI,
+    REG_M2_POSITION_LO,
+    REG_M2_FOLLOWING_ERROR,
+    REG_M2_QUEUE_PUSH,
+    REG_M2_QUEUE_DEPTH,
+    REG_M2_QUEUE_UNDERFLOW,
+    REG_M2_QUEUE_INDEX,
+    REG_M2_QUEUE_OVERFLOW,
+    REG_M2_QUEUE_STAGING = 0x00E0,
+
+    // Motor 2 -> Motor 1 coupling (0x00F0 - 0x00FF)
+    REG_GEAR_SOURCE = 0x00F0,
+    REG_GEAR_NUMERATOR,
+    REG_GEAR_DENOMINATOR,
+    REG_GEAR_OFFSET_HI,
+    REG_GEAR_OFFSET_LO,
+    REG_GEAR_COUPLING_KC,
+    REG_GEAR_SYNC_ERROR,
+
+    // Differential drive (0x0100 - 0x011F), Motor 1 = left wheel, Motor 2 = right wheel
+    REG_DRIVE_V_CMD = 0x0100,
+    REG_DRIVE_W_CMD,
+    REG_DRIVE_WHEEL_BASE,
+    REG_DRIVE_WHEEL_RADIUS,
+    REG_DRIVE_MAX_WHEEL_RPM,
+    REG_DRIVE_ACCEL,
+    REG_DRIVE_ALPHA,
+    REG_DRIVE_ODOM_RESET,
+    REG_DRIVE_ODOM_X_HI,
+    REG_DRIVE_ODOM_X_LO,
+    REG_DRIVE_ODOM_Y_HI,
+    REG_DRIVE_ODOM_Y_LO,
+    REG_DRIVE_ODOM_THETA,
+    REG_DRIVE_V_ACTUAL,
+    REG_DRIVE_W_ACTUAL,
+    REG_DRIVE_STATUS,
+
+    // Motor 1 thermal model (0x0120 - 0x012F)
+    REG_M1_THERMAL_RATED = 0x0120,
+    REG_M1_THERMAL_TAU,
+    REG_M1_THERMAL_HORIZON,
+    REG_M1_THERMAL_MOTOR,
+    REG_M1_THERMAL_BRIDGE,
+    REG_M1_THERMAL_LIMIT,
+
+    // Motor 2 thermal model (0x0130 - 0x013F)
+    REG_M2_THERMAL_RATED = 0x0130,
+    REG_M2_THERMAL_TAU,
+    REG_M2_THERMAL_HORIZON,
+    REG_M2_THERMAL_MOTOR,
+    REG_M2_THERMAL_BRIDGE,
+    REG_M2_THERMAL_LIMIT,
+
+    // Motor 1 stall detection (0x0140 - 0x014F)
+    REG_M1_STALL_REACTION = 0x0140,
+    REG_M1_STALL_CURRENT,
+    REG_M1_STALL_SPEED,
+    REG_M1_STALL_DUTY,
+    REG_M1_STALL_TIME,
+    REG_M1_STALL_REDUCE,
+    REG_M1_STALL_RETRY_DELAY,
+    REG_M1_STALL_RETRY_MAX,
+    REG_M1_STALL_COUNT,
+    REG_M1_STALL_RETRIES,
+    REG_M1_STALL_STATE,
+
+    // Motor 2 stall detection (0x0150 - 0x015F)
+    REG_M2_STALL_REACTION = 0x0150,
+    REG_M2_STALL_CURRENT,
+    REG_M2_STALL_SPEED,
+    REG_M2_STALL_DUTY,
+    REG_M2_STALL_TIME,
+    REG_M2_STALL_REDUCE,
+    REG_M2_STALL_RETRY_DELAY,
+    REG_M2_STALL_RETRY_MAX,
+    REG_M2_STALL_COUNT,
+    REG_M2_STALL_RETRIES,
+    REG_M2_STALL_STATE,
+
+    // Motor 1 LINEAR mode lookup table (0x0160 - 0x017F)
+    REG_M1_LIN_ENABLE = 0x0160,
+    REG_M1_LIN_DEADBAND,
+    REG_M1_LIN_STATE,
+    REG_M1_LIN_TABLE = 0x0164,   // LINEAR_LUT_POINTS duty values
+
+    // Motor 2 LINEAR mode lookup table (0x0180 - 0x019F)
+    REG_M2_LIN_ENABLE = 0x0180,
+    REG_M2_LIN_DEADBAND,
+    REG_M2_LIN_STATE,
+    REG_M2_LIN_TABLE = 0x0184,   // LINEAR_LUT_POINTS duty values
+
+    // Motor 1 ON/OFF mode (0x01A0 - 0x01AF)
+    REG_M1_ONOFF_SOURCE = 0x01A0,
+    REG_M1_ONOFF_PIN,
+    REG_M1_ONOFF_ACTIVE_LOW,
+    REG_M1_ONOFF_VALUE,
+    REG_M1_ONOFF_ON_LEVEL,
+    REG_M1_ONOFF_OFF_LEVEL,
+    REG_M1_ONOFF_DUTY,
+    REG_M1_ONOFF_SOFT_START,
+    REG_M1_ONOFF_MIN_ON,
+    REG_M1_ONOFF_MIN_OFF,
+    REG_M1_ONOFF_STATE,
+
+    // Motor 2 ON/OFF mode (0x01B0 - 0x01BF)
+    REG_M2_ONOFF_SOURCE = 0x01B0,
+    REG_M2_ONOFF_PIN,
+    REG_M2_ONOFF_ACTIVE_LOW,
+    REG_M2_ONOFF_VALUE,
+    REG_M2_ONOFF_ON_LEVEL,
+    REG_M2_ONOFF_OFF_LEVEL,
+    REG_M2_ONOFF_DUTY,
+    REG_M2_ONOFF_SOFT_START,
+    REG_M2_ONOFF_MIN_ON,
+    REG_M2_ONOFF_MIN_OFF,
+    REG_M2_ONOFF_STATE,
+
+    // Proximity safety envelope (0x01C0 - 0x01CF)
+    REG_PROX_SOURCE = 0x01C0,
+    REG_PROX_PIN,
+    REG_PROX_ACTIVE_LOW,
+    REG_PROX_DISTANCE,
+    REG_PROX_TIMEOUT,
+    REG_PROX_MOTORS,
+    REG_PROX_GUARD,
+    REG_PROX_SAFE,
+    REG_PROX_SLOW,
+    REG_PROX_CREEP,
+    REG_PROX_SCALE,
+    REG_PROX_STATUS,
+    REG_PROX_FRAMES,
+
+    // PWM duty post-processing (0x01D0 - 0x01DF)
+    REG_PWM_MIN_PULSE = 0x01D0,
+    REG_PWM_DITHER,
+    REG_PWM_MIN_DUTY,
+
+    // Motor state machine (0x01E0 - 0x01FF)
+    REG_MSM_M1_STATE = 0x01E0,
+    REG_MSM_M2_STATE,
+    REG_MSM_TRANSITIONS,
+    REG_MSM_REJECTED,
+    REG_MSM_LOG_COUNT,
+    REG_MSM_LOG_CLEAR,
+    REG_MSM_LOG = 0x01E8,       // MOTOR_STATE_LOG_DEPTH entries, newest first
+
+    TOTAL_REG_COUNT = 0x0200  // Use this to size the holding register array
 } ModbusRegisterMap_t;
 
+// Motor error codes (REG_Mx_ERROR_CODE), latched until REG_RESET_ERROR_COMMAND
+typedef enum {
+    MOTOR_ERR_NONE = 0,
+    MOTOR_ERR_OVERCURRENT = 1,    // ADC analog watchdog trip, PWM killed in hardware
+    MOTOR_ERR_STALL = 2           // rotor blocked (REG_Mx_STALL_x), reaction per REG_Mx_STALL_REACTION
+} MotorErrorCode_t;
+
+// Motor status word bits (REG_Mx_STATUS_WORD)
+#define MOTOR_STATUS_ENABLED        (1U << 0)   // output stage driven by the active mode
+#define MOTOR_STATUS_FAULT          (1U << 1)   // error code latched, output off
+#define MOTOR_STATUS_CURRENT_LIMIT  (1U << 2)   // speed loop saturated at the torque limit
+#define MOTOR_STATUS_TUNING         (1U << 3)   // relay auto-tune driving the output
+#define MOTOR_STATUS_IDENT          (1U << 4)   // parameter identification driving the output
+#define MOTOR_STATUS_IN_POSITION    (1U << 5)   // position mode: |target - position| <= window
+#define MOTOR_STATUS_MOVE_DONE      (1U << 6)   // position mode: move profile finished
+#define MOTOR_STATUS_DERATING       (1U << 7)   // I2t model holds the current below the configured limit
+#define MOTOR_STATUS_STALL          (1U << 8)   // stall reaction active (stopped, braking, reduced or retrying)
+#define MOTOR_STATUS_STOPPING       (1U << 9)   // controlled stop (STOP_MODE_DECEL) in progress
+#define MOTOR_STATUS_PROX_SLOW      (1U << 10)  // speed scaled down by the proximity envelope
+#define MOTOR_STATUS_PROX_STOP      (1U << 11)  // held at zero: obstacle inside the safe distance or sensor lost
+
+// REG_PWM_OUTPUT_MODE values
+#define PWM_OUTPUT_SINGLE           0U          // PWM pin only, off-time current through the body diodes
+#define PWM_OUTPUT_COMPLEMENTARY    1U          // PWM + inverted low-side gate with dead-time (synchronous)
+
+// REG_PARAM_SAVE values
+#define PARAM_SAVE_IDLE             0U          // last save done (or none requested)
+#define PARAM_SAVE_REQUEST          1U          // write to save, cleared when done
+#define PARAM_SAVE_FAILED           2U          // refused (motor running) or flash error
+
+// Motor register block - same layout for Motor 1 (0x0000) and Motor 2 (0x0010)
+typedef struct {
+    uint16_t mode;            // 0x00
+    uint16_t onoff_en;        // 0x01
+    uint16_t linear_en;       // 0x02
+    uint16_t pid_en;          // 0x03
+    int16_t  cmd_speed;       // 0x04
+    uint16_t linear_input;    // 0x05
+    int16_t  actual_speed;    // 0x06
+    uint16_t direction;       // 0x07
+    uint16_t kp;              // 0x08
+    uint16_t ki;              // 0x09
+    uint16_t kd;              // 0x0A
+    uint16_t status;          // 0x0B
+    uint16_t error;           // 0x0C
+    int16_t  current_ma;      // 0x0D RO: motor current (mA), signed
+    uint16_t thermal_pct;     // 0x0E RO: hottest of motor / bridge I2t state (%), 100 = rated
+    uint16_t reserved;        // 0x0F
+} tMotorRegisters;
+
+// Motor control block - same layout for Motor 1 (0x0030) and Motor 2 (0x0050)
+typedef struct {
+    uint16_t cur_kp;          // 0x00 current loop Kp (per-mille duty per A)
+    uint16_t cur_ki;          // 0x01 current loop Ki (per-mille duty per A*ms)
+    uint16_t current_limit_ma;// 0x02 torque limit = speed loop output clamp (mA)
+    int16_t  current_ref_ma;  // 0x03 RO: current setpoint from the speed loop (mA)
+    uint16_t encoder_ppr;     // 0x04 encoder pulses per rev per channel, 0 = none
+    uint16_t speed_timestamp; // 0x05 RO: ms tick (low 16 bits) of actual_speed
+    uint16_t motor_r_mohm;    // 0x06 armature resistance (mOhm)
+    uint16_t motor_l_uh;      // 0x07 armature inductance (uH)
+    uint16_t motor_ke;        // 0x08 back-EMF constant (uV/RPM), 0 = no sensorless feedback
+    uint16_t tune_cmd;        // 0x09 write 1 = start relay auto-tune, 0 = abort (auto-clears)
+    uint16_t tune_state;      // 0x0A RO: 0 idle, 1 running, 2 done, 3 failed
+    uint16_t tune_progress;   // 0x0B RO: 0-100 %
+    uint16_t tune_amplitude;  // 0x0C relay amplitude (permille duty in PID, mA in CASCADE)
+    uint16_t tune_hysteresis; // 0x0D relay hysteresis (RPM)
+    uint16_t tune_ku;         // 0x0E RO: ultimate gain (x100, same units as Kp)
+    uint16_t tune_tu_ms;      // 0x0F RO: ultimate period (ms)
+    uint16_t motor_j;         // 0x10 inertia as current per acceleration (uA per RPM/s)
+    uint16_t motor_fv;        // 0x11 viscous friction (uA per RPM)
+    uint16_t motor_fc;        // 0x12 Coulomb friction (mA)
+    uint16_t ident_cmd;       // 0x13 write 1 = run parameter identification (motor disabled)
+    uint16_t ident_state;     // 0x14 RO: 0 idle, 1 step, 2 ramp, 3 done, 4 failed
+    uint16_t ident_duty;      // 0x15 identification step amplitude (permille duty)
+    uint16_t accel_limit;     // 0x16 speed ramp acceleration (RPM/s), 0 = step
+    uint16_t decel_limit;     // 0x17 speed ramp deceleration (RPM/s), 0 = step
+    uint16_t ff_kv;           // 0x18 velocity feed-forward (x1000, output per RPM)
+    uint16_t ff_ka;           // 0x19 acceleration feed-forward (x1000, output per RPM/s)
+    uint16_t ff_static;       // 0x1A static friction compensation (output units)
+    uint16_t stop_mode;       // 0x1B STOP_MODE_x, applied when the master disables the motor
+    uint16_t stop_decel;      // 0x1C DECEL: RPM/s in speed modes, per-mille duty/s in ONOFF/LINEAR, 0 = decel_limit / step
+    uint16_t regen_limit_ma;  // 0x1D DECEL: max current fed back into the bridge supply (mA), 0 = no limit
+    uint16_t brake_duty;      // 0x1E BRAKE: short-brake strength (per-mille)
+    uint16_t reserved;        // 0x1F
+} tMotorControlRegisters;
+
+// REG_Mx_STOP_MODE values
+#define STOP_MODE_COAST             0U          // bridge open, motor spins down on friction
+#define STOP_MODE_BRAKE             1U          // both low sides on, energy burnt in the winding
+#define STOP_MODE_DECEL             2U          // speed ramped to 0 under control, regen-limited
+
+// Gain schedule (REG_Mx_SCHED_x)
+#define GAIN_SCHED_MAX_POINTS       6U
+#define GAIN_SCHED_SOURCE_OFF       0U          // fixed gains REG_Mx_PID_Kx
+#define GAIN_SCHED_SOURCE_SPEED     1U          // x = |actual speed| (RPM)
+#define GAIN_SCHED_SOURCE_CURRENT   2U          // x = |motor current| (mA)
+#define GAIN_SCHED_ACTIVE_NONE      0xFFFFU     // schedule off or table invalid
+
+typedef struct {
+    uint16_t x;               // breakpoint, strictly increasing
+    uint16_t kp;              // same units as REG_Mx_PID_KP/KI/KD of the running mode
+    uint16_t ki;
+    uint16_t kd;
+} tGainSchedulePoint;
+
+// Gain schedule block - same layout for Motor 1 (0x0070) and Motor 2 (0x0090)
+typedef struct {
+    uint16_t source;          // 0x00 GAIN_SCHED_SOURCE_x
+    uint16_t count;           // 0x01 breakpoints used (2-6)
+    uint16_t active;          // 0x02 RO: segment in use (i = between point i and i+1)
+    uint16_t reserved0;       // 0x03
+    tGainSchedulePoint points[GAIN_SCHED_MAX_POINTS]; // 0x04 - 0x1B
+    uint16_t reserved[4];     // 0x1C - 0x1F
+} tGainScheduleRegisters;
+
+// REG_Mx_MOVE_COMMAND values (auto-clear once accepted)
+#define MOVE_CMD_NONE               0U
+#define MOVE_CMD_ABSOLUTE           1U          // flush the queue, move to target position
+#define MOVE_CMD_RELATIVE           2U          // flush the queue, move by target position from the current target
+#define MOVE_CMD_STOP               3U          // flush the queue, decelerate to a stop, then hold
+#define MOVE_CMD_SET_POSITION       4U          // set the current position to target position (stopped)
+#define MOVE_CMD_CLEAR_COUNTERS     5U          // clear Queue_Underflow and Queue_Overflow
+
+// Queued motion segment (REG_Mx_QUEUE_STAGING), same fields as a single move
+#define MOTION_QUEUE_STAGING        4U          // segments per REG_Mx_QUEUE_PUSH
+
+typedef struct {
+    uint16_t target_pos_hi;
+    uint16_t target_pos_lo;
+    uint16_t vmax;            // RPM
+    uint16_t accel;           // RPM/s, 0 = step
+} tMotionSegmentRegisters;
+
+// Motion block - same layout for Motor 1 (0x00B0) and Motor 2 (0x00D0)
+// Command is last so one FC16 of target..command starts the move with the new values
+typedef struct {
+    uint16_t target_pos_hi;   // 0x00 target position (encoder counts x4), int32 high word
+    uint16_t target_pos_lo;   // 0x01 low word
+    uint16_t move_vmax;       // 0x02 profile max velocity (RPM)
+    uint16_t move_accel;      // 0x03 profile acceleration / deceleration (RPM/s), 0 = step
+    uint16_t move_cmd;        // 0x04 MOVE_CMD_x
+    uint16_t pos_kp;          // 0x05 position loop gain (x100, 1/s)
+    uint16_t in_pos_window;   // 0x06 in-position band (counts)
+    uint16_t position_hi;     // 0x07 RO: multi-turn position (counts), int32 high word
+    uint16_t position_lo;     // 0x08 RO: low word
+    int16_t  following_error; // 0x09 RO: profile position - position (counts), saturated
+    uint16_t queue_push;      // 0x0A write n = append staged segments 0..n-1 (auto-clears)
+    uint16_t queue_depth;     // 0x0B RO: segments waiting
+    uint16_t queue_underflow; // 0x0C RO: queue ran dry mid-stream while the axis was moving
+    uint16_t queue_index;     // 0x0D RO: segments started since the queue was flushed
+    uint16_t queue_overflow;  // 0x0E RO: segments dropped, queue full
+    uint16_t reserved0;       // 0x0F
+    tMotionSegmentRegisters staging[MOTION_QUEUE_STAGING]; // 0x10 - 0x1F
+} tMotionRegisters;
+
+// REG_GEAR_SOURCE values
+#define GEAR_SOURCE_SPEED           0U          // M2 speed ref = ratio * M1 measured speed
+#define GEAR_SOURCE_POSITION        1U          // M2 position ref = ratio * M1 position + offset (both encoders)
+
+// Coupling block (0x00F0): Motor 2 in mode 6 (GEARED) follows Motor 1
+typedef struct {
+    uint16_t source;          // 0x00 GEAR_SOURCE_x
+    int16_t  numerator;       // 0x01 ratio numerator (signed: negative = opposite direction)
+    uint16_t denominator;     // 0x02 ratio denominator, 0 is treated as 1
+    uint16_t offset_hi;       // 0x03 phase offset (M2 counts), int32 high word
+    uint16_t offset_lo;       // 0x04 low word
+    uint16_t coupling_kc;     // 0x05 cross-coupling gain (x100), slows M1 while M2 lags
+    int16_t  sync_error;      // 0x06 RO: M2 reference - M2 actual (counts or RPM by source)
+    uint16_t reserved[9];     // 0x07 - 0x0F
+} tCouplingRegisters;
+
+// REG_DRIVE_STATUS bits
+#define DRIVE_STATUS_SATURATED      (1U << 0)   // wheel speeds scaled down to max_wheel_rpm
+
+// Differential drive block (0x0100), used by motors in mode 7 (DIFF_DRIVE)
+typedef struct {
+    int16_t  v_cmd;           // 0x00 linear velocity (mm/s)
+    int16_t  w_cmd;           // 0x01 angular velocity (mrad/s), positive = counter-clockwise
+    uint16_t wheel_base_mm;   // 0x02 distance between wheel contact points (mm)
+    uint16_t wheel_radius;    // 0x03 wheel radius (0.01 mm)
+    uint16_t max_wheel_rpm;   // 0x04 wheel speed limit (RPM), 0 = none
+    uint16_t accel;           // 0x05 v ramp (mm/s^2), 0 = step
+    uint16_t alpha;           // 0x06 w ramp (mrad/s^2), 0 = step
+    uint16_t odom_reset;      // 0x07 write 1 = zero x, y, theta (auto-clears)
+    uint16_t odom_x_hi;       // 0x08 RO: x (mm), int32 high word
+    uint16_t odom_x_lo;       // 0x09
+    uint16_t odom_y_hi;       // 0x0A RO: y (mm), int32 high word
+    uint16_t odom_y_lo;       // 0x0B
+    int16_t  odom_theta;      // 0x0C RO: heading (mrad), -3142..3141
+    int16_t  v_actual;        // 0x0D RO: measured linear velocity (mm/s)
+    int16_t  w_actual;        // 0x0E RO: measured angular velocity (mrad/s)
+    uint16_t status;          // 0x0F RO: DRIVE_STATUS_x
+    uint16_t reserved[16];    // 0x10 - 0x1F
+} tDriveRegisters;
+
+// I2t thermal model - same layout for Motor 1 (0x0120) and Motor 2 (0x0130)
+typedef struct {
+    uint16_t motor_rated_ma;  // 0x00 motor continuous current (mA), 0 = no motor model
+    uint16_t motor_tau_s;     // 0x01 motor thermal time constant (s)
+    uint16_t horizon_ms;      // 0x02 derating look-ahead (ms), 0 = monitor only
+    uint16_t motor_pct;       // 0x03 RO: motor I2t state (%), 100 = steady state at rated current
+    uint16_t bridge_pct;      // 0x04 RO: H-bridge I2t state (%)
+    uint16_t limit_ma;        // 0x05 RO: current allowed by the thermal model (mA)
+    uint16_t reserved[10];    // 0x06 - 0x0F
+} tThermalRegisters;
+
+// REG_Mx_STALL_REACTION values
+#define STALL_REACTION_OFF          0U          // no detection
+#define STALL_REACTION_COAST        1U          // output off, bridge open
+#define STALL_REACTION_BRAKE        2U          // output off, low sides shorted until the error is reset
+#define STALL_REACTION_REDUCE       3U          // keep running at reduce_pct of the torque limit
+#define STALL_REACTION_RETRY        4U          // coast, restart after retry_delay << n, up to retry_max times
+
+// Stall detection - same layout for Motor 1 (0x0140) and Motor 2 (0x0150)
+typedef struct {
+    uint16_t reaction;        // 0x00 STALL_REACTION_x
+    uint16_t current_ma;      // 0x01 stall when |current| >= this (mA) ...
+    uint16_t speed_rpm;       // 0x02 ... and |speed| <= this (RPM) ...
+    uint16_t duty_pm;         // 0x03 ... and |duty| >= this (per-mille) ...
+    uint16_t time_ms;         // 0x04 ... for this long without a break (ms)
+    uint16_t reduce_pct;      // 0x05 REDUCE: torque limit after a stall (%)
+    uint16_t retry_delay_ms;  // 0x06 RETRY: wait before the first restart (ms), doubles each retry
+    uint16_t retry_max;       // 0x07 RETRY: restarts before the error stays latched
+    uint16_t count;           // 0x08 RO: stalls detected since boot
+    uint16_t retries;         // 0x09 RO: restarts used (cleared after 2 s stall-free)
+    uint16_t state;           // 0x0A RO: 0 ok, 1 stalled (latched), 2 waiting to retry
+    uint16_t reserved[5];     // 0x0B - 0x0F
+} tStallRegisters;
+
+// LINEAR mode lookup table (REG_Mx_LIN_x): uniform breakpoints, input 0-1000
+// split into LINEAR_LUT_SEGMENTS equal segments
+#define LINEAR_LUT_SEGMENTS         16U
+#define LINEAR_LUT_POINTS           (LINEAR_LUT_SEGMENTS + 1U)
+#define LINEAR_LUT_STATE_OFF        0U          // linear_input * max duty / 1000
+#define LINEAR_LUT_STATE_ACTIVE     1U
+#define LINEAR_LUT_STATE_INVALID    2U          // table not rising or > 1000: proportional mapping used
+
+// LINEAR lookup table - same layout for Motor 1 (0x0160) and Motor 2 (0x0180)
+typedef struct {
+    uint16_t enable;          // 0x00 1 = map linear_input through the table
+    uint16_t deadband;        // 0x01 duty where the motor starts to turn (per-mille), added for input > 0
+    uint16_t state;           // 0x02 RO: LINEAR_LUT_STATE_x
+    uint16_t reserved0;       // 0x03
+    uint16_t table[LINEAR_LUT_POINTS]; // 0x04 - 0x14 duty above the dead band (per-mille) at input 1000*i/16
+    uint16_t reserved[11];    // 0x15 - 0x1F
+} tLinearRegisters;
+
+// REG_Mx_ONOFF_SOURCE values: where the run demand comes from while ONOFF_Enable = 1
+#define ONOFF_SOURCE_REGISTER       0U          // always on while ONOFF_Enable = 1
+#define ONOFF_SOURCE_VALUE          1U          // onoff_value compared with on_level / off_level
+#define ONOFF_SOURCE_PIN            2U          // digital input IN1-IN4 (onoff_pin)
+
+// ON/OFF mode - same layout for Motor 1 (0x01A0) and Motor 2 (0x01B0)
+typedef struct {
+    uint16_t source;          // 0x00 ONOFF_SOURCE_x
+    uint16_t pin;             // 0x01 PIN: input 1-4 (IN1-IN4), not one used by an enabled encoder
+    uint16_t active_low;      // 0x02 PIN: 1 = on while the input is low
+    int16_t  value;           // 0x03 VALUE: process value written by the master (e.g. level, pressure)
+    int16_t  on_level;        // 0x04 VALUE: turn on at this value ...
+    int16_t  off_level;       // 0x05 ... off at this one; on > off = on when high, on < off = on when low
+    uint16_t on_duty;         // 0x06 duty while on (per-mille)
+    uint16_t soft_start_ms;   // 0x07 duty ramp 0 -> on_duty at turn-on (ms), 0 = step
+    uint16_t min_on_ms;       // 0x08 minimum run time once started (ms)
+    uint16_t min_off_ms;      // 0x09 minimum rest time before restarting (ms)
+    uint16_t state;           // 0x0A RO: 0 off, 1 soft-start, 2 on, 3 waiting min-off, 4 waiting min-on
+    uint16_t reserved[5];     // 0x0B - 0x0F
+} tOnOffRegisters;
+
+// REG_PROX_SOURCE values
+#define PROXIMITY_SOURCE_OFF        0U
+#define PROXIMITY_SOURCE_REGISTER   1U          // master writes REG_PROX_DISTANCE
+#define PROXIMITY_SOURCE_TFMINI     2U          // USART1 RX (PA10) 115200, TFmini / TF-Luna frames (cm)
+#define PROXIMITY_SOURCE_A02        3U          // USART1 RX (PA10) 9600, A02YYUW ultrasonic frames (mm)
+#define PROXIMITY_SOURCE_PIN        4U          // obstacle switch on IN1-IN4: active = inside the safe distance
+
+// REG_PROX_GUARD values, direction of travel the envelope limits
+#define PROXIMITY_GUARD_BOTH        0U
+#define PROXIMITY_GUARD_FORWARD     1U          // positive speed (DIFF_DRIVE: positive v)
+#define PROXIMITY_GUARD_REVERSE     2U          // negative speed
+
+// REG_PROX_STATUS bits
+#define PROXIMITY_STATUS_SLOW       (1U << 0)   // distance inside slow_cm, speed scaled
+#define PROXIMITY_STATUS_STOP       (1U << 1)   // distance inside safe_cm or sensor lost
+#define PROXIMITY_STATUS_LOST       (1U << 2)   // UART source: no valid frame within timeout_ms
+
+#define PROXIMITY_DISTANCE_FAR      0xFFFFU     // no obstacle in range
+
+// Proximity safety envelope (0x01C0): one distance sensor, applied to the motors in REG_PROX_MOTORS
+typedef struct {
+    uint16_t source;          // 0x00 PROXIMITY_SOURCE_x
+    uint16_t pin;             // 0x01 PIN: input 1-4 (IN1-IN4), not one used by an enabled encoder
+    uint16_t active_low;      // 0x02 PIN: 1 = obstacle while the input is low
+    uint16_t distance_cm;     // 0x03 REGISTER: written by the master; other sources: RO, last reading (cm)
+    uint16_t timeout_ms;      // 0x04 UART sources: no frame for this long = sensor lost (stop), 0 = no check
+    uint16_t motors;          // 0x05 bit 0 = Motor 1, bit 1 = Motor 2 (DIFF_DRIVE: either bit scales v)
+    uint16_t guard;           // 0x06 PROXIMITY_GUARD_x
+    uint16_t safe_cm;         // 0x07 hard stop at or below this distance (cm)
+    uint16_t slow_cm;         // 0x08 speed scaled down below this distance (cm)
+    uint16_t creep_pct;       // 0x09 speed left just outside safe_cm (%)
+    uint16_t scale_pct;       // 0x0A RO: speed allowed by the envelope (%)
+    uint16_t status;          // 0x0B RO: PROXIMITY_STATUS_x
+    uint16_t frames;          // 0x0C RO: valid UART frames received (wraps)
+    uint16_t reserved[3];     // 0x0D - 0x0F
+} tProximityRegisters;
+
+// PWM duty post-processing (0x01D0), both channels
+typedef struct {
+    uint16_t min_pulse_ns;    // 0x00 shorter on / off pulses are skipped or stretched, 0 = off
+    uint16_t dither;          // 0x01 1 = carry the quantization error to the next fast loop tick
+    uint16_t min_duty_pm;     // 0x02 RO: min_pulse_ns as a fraction of the PWM period (per mille)
+    uint16_t reserved[13];    // 0x03 - 0x0F
+} tPwmPostRegisters;
+
+// Motor state machine (REG_MSM_x). States: 0 disabled, 1 ready (enabled, held at zero
+// by the proximity envelope), 2 running, 3 stopping, 4 fault, 5 recovering (stall retry)
+#define MOTOR_STATE_LOG_DEPTH       6U
+
+// REG_MSM_LOG entry: transition = motor << 12 | mode << 8 | from << 4 | to
+typedef struct {
+    uint16_t time_hi;         // 0x00 RTOS tick (ms) of the transition
+    uint16_t time_lo;         // 0x01
+    uint16_t transition;      // 0x02
+    uint16_t event;           // 0x03 cause: 0 enable, 1 disable, 2 stop, 3 stopped, 4 fault, 5 backoff,
+                              //      6 reset, 7 hold, 8 release, 9 mode change
+} tStateLogRegisters;
+
+// Motor state machine (0x01E0), both motors
+typedef struct {
+    uint16_t m1_state;        // 0x00 RO
+    uint16_t m2_state;        // 0x01 RO
+    uint16_t transitions;     // 0x02 RO: state changes since boot (wraps)
+    uint16_t rejected;        // 0x03 RO: events refused by the transition table (wraps)
+    uint16_t log_count;       // 0x04 RO: valid log entries
+    uint16_t log_clear;       // 0x05 write 1 = clear the log
+    uint16_t reserved[2];     // 0x06 - 0x07
+    tStateLogRegisters log[MOTOR_STATE_LOG_DEPTH]; // 0x08 - 0x1F
+} tStateMachineRegisters;
+
 // Struct for holding register values - FreeModbus compatible
+// Field offset (in 16-bit words) == Modbus register address
 typedef struct {
-    // Motor 1 (0x0000 - 0x000D)
-    uint16_t m1_mode;
-    uint16_t m1_onoff_en;
-    uint16_t m1_linear_en;
-    uint16_t m1_pid_en;
-    int16_t  m1_cmd_speed;
-    uint16_t m1_linear_input;
-    int16_t  m1_actual_speed;
-    uint16_t m1_direction;
-    uint16_t m1_kp;
-    uint16_t m1_ki;
-    uint16_t m1_kd;
-    uint16_t m1_status;
-    uint16_t m1_error;
-
-    // Motor 2 (0x0010 - 0x001D)
-    uint16_t m2_mode;
-    uint16_t m2_onoff_en;
-    uint16_t m2_linear_en;
-    uint16_t m2_pid_en;
-    int16_t  m2_cmd_speed;
-    uint16_t m2_linear_input;
-    int16_t  m2_actual_speed;
-    uint16_t m2_direction;
-    uint16_t m2_kp;
-    uint16_t m2_ki;
-    uint16_t m2_kd;
-    uint16_t m2_status;
-    uint16_t m2_error;
-
-    // System (0x0020 - 0x0026)
+    tMotorRegisters m1;       // 0x0000 - 0x000F
+    tMotorRegisters m2;       // 0x0010 - 0x001F
+
+    // System (0x0020 - 0x002F)
     uint16_t device_id;
     uint16_t firmware_ver;
     uint16_t system_status;
@@ -124,11 +699,60 @@ typedef struct {
     uint16_t reset_error_cmd;
     uint16_t config_baudrate;
     uint16_t config_parity;
+    uint16_t sysclk_mhz;      // RO: SYSCLK actually running
+    uint16_t pwm_freq_khz;    // PWM switching frequency, 1-100 kHz
+    uint16_t pwm_align;       // 0 = edge-aligned, 1 = center-aligned
+    uint16_t pwm_resolution;  // RO: duty steps per PWM period
+    uint16_t ocp_threshold_ma;// Overcurrent trip level (mA), 0 = disabled
+    uint16_t vbus_mv;         // Bridge supply voltage (mV), not measured on this board
+    uint16_t param_save;      // write 1 = save parameters to flash (PARAM_SAVE_x)
+    uint16_t pwm_output;      // PWM_OUTPUT_x
+    uint16_t pwm_dead_time_ns;// complementary dead-time (ns), read back rounded up to the timer step
+
+    tMotorControlRegisters m1_ctrl;   // 0x0030 - 0x004F
+    tMotorControlRegisters m2_ctrl;   // 0x0050 - 0x006F
+
+    tGainScheduleRegisters m1_sched;  // 0x0070 - 0x008F
+    tGainScheduleRegisters m2_sched;  // 0x0090 - 0x00AF
+
+    tMotionRegisters m1_motion;       // 0x00B0 - 0x00CF
+    tMotionRegisters m2_motion;       // 0x00D0 - 0x00EF
+
+    tCouplingRegisters coupling;      // 0x00F0 - 0x00FF
+    tDriveRegisters drive;            // 0x0100 - 0x011F
+
+    tThermalRegisters m1_thermal;     // 0x0120 - 0x012F
+    tThermalRegisters m2_thermal;     // 0x0130 - 0x013F
+
+    tStallRegisters m1_stall;         // 0x0140 - 0x014F
+    tStallRegisters m2_stall;         // 0x0150 - 0x015F
+
+    tLinearRegisters m1_linear;       // 0x0160 - 0x017F
+    tLinearRegisters m2_linear;       // 0x0180 - 0x019F
+
+    tOnOffRegisters m1_onoff;         // 0x01A0 - 0x01AF
+    tOnOffRegisters m2_onoff;         // 0x01B0 - 0x01BF
+
+    tProximityRegisters proximity;    // 0x01C0 - 0x01CF
+
+    tPwmPostRegisters pwm_post;       // 0x01D0 - 0x01DF
+
+    tStateMachineRegisters msm;       // 0x01E0 - 0x01FF
 } tModbusRegisters;
 
 // Global instance
 extern tModbusRegisters g_modbus_data;
 
+// Motor register block by motor index (0 = Motor 1, 1 = Motor 2)
+#define MODBUS_MOTOR_REGS(id)       ((id) == 0 ? &g_modbus_data.m1 : &g_modbus_data.m2)
+#define MODBUS_MOTOR_CTRL(id)       ((id) == 0 ? &g_modbus_data.m1_ctrl : &g_modbus_data.m2_ctrl)
+#define MODBUS_MOTOR_SCHED(id)      ((id) == 0 ? &g_modbus_data.m1_sched : &g_modbus_data.m2_sched)
+#define MODBUS_MOTOR_MOTION(id)     ((id) == 0 ? &g_modbus_data.m1_motion : &g_modbus_data.m2_motion)
+#define MODBUS_MOTOR_THERMAL(id)    ((id) == 0 ? &g_modbus_data.m1_thermal : &g_modbus_data.m2_thermal)
+#define MODBUS_MOTOR_STALL(id)      ((id) == 0 ? &g_modbus_data.m1_stall : &g_modbus_data.m2_stall)
+#define MODBUS_MOTOR_LINEAR(id)     ((id) == 0 ? &g_modbus_data.m1_linear : &g_modbus_data.m2_linear)
+#define MODBUS_MOTOR_ONOFF(id)      ((id) == 0 ? &g_modbus_data.m1_onoff : &g_modbus_data.m2_onoff)
+
 // FreeModbus callback function declaration
 eMBErrorCode eMBRegHoldingCB(UCHAR *pucRegBuffer, USHORT usAddress,
                               USHORT usNRegs, eMBRegisterMode eMode);
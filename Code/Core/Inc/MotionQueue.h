@@ -0,0 +1,56 @@
+/*
+ * MotionQueue.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_MOTIONQUEUE_H_
+#define INC_MOTIONQUEUE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Mot doan chuyen dong: di toi target voi van toc / gia toc rieng
+ */
+typedef struct {
+    int32_t  target;        /**< Vi tri dich (xung x4) */
+    uint16_t vmax_rpm;
+    uint16_t accel_rpm_s;
+} MotionSegment_t;
+
+/**
+ * @brief Hang doi vong CONFIG_MOTION_QUEUE_DEPTH doan moi motor
+ *
+ * Chi ghi va doc tu task dieu khien cua motor do (khong can khoa).
+ */
+bool     MotionQueue_Push(uint8_t motor, const MotionSegment_t *segment);
+
+/**
+ * @brief Lay doan ke tiep, tang chi so doan
+ */
+bool     MotionQueue_Pop(uint8_t motor, MotionSegment_t *out);
+bool     MotionQueue_Peek(uint8_t motor, MotionSegment_t *out);
+
+/**
+ * @brief Xoa hang doi va chi so doan. Underflow / overflow giu nguyen
+ */
+void     MotionQueue_Flush(uint8_t motor);
+
+/**
+ * @brief Xoa bo dem underflow, overflow (lenh cua master)
+ */
+void     MotionQueue_ClearCounters(uint8_t motor);
+
+/**
+ * @brief Ghi nhan hang doi can trong luc truc con dang chay
+ */
+void     MotionQueue_NoteUnderflow(uint8_t motor);
+
+uint16_t MotionQueue_GetDepth(uint8_t motor);
+uint16_t MotionQueue_GetIndex(uint8_t motor);       /**< So doan da bat dau tu lan Flush */
+uint16_t MotionQueue_GetUnderflows(uint8_t motor);
+uint16_t MotionQueue_GetOverflows(uint8_t motor);   /**< Doan bi tu choi vi day */
+
+#endif /* INC_MOTIONQUEUE_H_ */
@@ -2,88 +2,142 @@
 #define __MOTORDC_H
 
 #include "stdint.h"
-
-
-
+#include <stdbool.h>
+#include "ModbusMap.h"
+#include "PID.h"
+#include "Ramp.h"
+#include "GainSchedule.h"
+#include "MoveProfile.h"
+
+typedef enum {
+	MOTOR_MODE_ONOFF = 1,
+	MOTOR_MODE_LINEAR = 2,
+	MOTOR_MODE_PID = 3,             /**< PID toc do -> duty */
+	MOTOR_MODE_CASCADE = 4,         /**< PID toc do -> dong dat -> PI dong dien -> duty */
+	MOTOR_MODE_POSITION = 5,        /**< P vi tri -> CASCADE (can encoder) */
+	MOTOR_MODE_GEARED = 6,          /**< Chi Motor 2: bam theo Motor 1 (ti so, lech pha) -> CASCADE */
+	MOTOR_MODE_DIFF_DRIVE = 7       /**< Banh robot vi sai: v/w -> toc do banh -> PID (duty) */
+} MotorMode_t;
 
 typedef struct {
-	float _kp;
-	float _ki;
-	float _kd;
-	float _accelerationLimit;       /**< Gioi han tang toc (% cua _maxDuty) */
-	float _decelerationLimit;/**< He so D cua PID */
-	float _targetSpee1;             /**< Toc do muc tieu (0-100%) */
-	float _currentSpeed;            /**< Toc do hien tai (0-100%) */
-
-	/* Bien noi bo cho PID */
-	float _error;                   /**< Sai so hien tai */
-	float _lastError;               /**< Sai so vong truoc */
-	float _integral;                /**< Gia tri tich phan */
-	float _output;                  /**< Gia tri dau ra dieu khien (0-100%) */
+	uint8_t _id;                    /**< 0 = Motor 1, 1 = Motor 2 */
+	MotorMode_t _mode;
+	bool _enabled;                  /**< Dang dieu khien output theo _mode */
+
+	tMotorRegisters *_regs;
+	tMotorControlRegisters *_ctrl;
+	tGainScheduleRegisters *_sched;
+	tMotionRegisters *_motion;
+	tThermalRegisters *_thermal;
+	tStallRegisters *_stall;
+	tLinearRegisters *_linear;
+	tOnOffRegisters *_onoff;
+
+	/* PID so nguyen (PID.h) */
+	PID_t _speedPid;                /**< Vong ngoai 1 kHz: ra duty (PID) hoac mA (CASCADE) */
+	PID_t _currentPid;              /**< Vong trong, chay trong ISR CurrentSense (CASCADE) */
+	uint32_t _currentLoopHz;        /**< Tan so da dung de quy doi gain vong dong */
+	GainSchedule_t _schedule;       /**< Gain vong toc do theo toc do / dong (thay Kp/Ki/Kd) */
+
+	int32_t _targetSpeed;           /**< Toc do muc tieu (RPM), co dau theo huong */
+	Ramp_t _ramp;                   /**< Doc toc do: _speedRef / _accelRef (PID, CASCADE) */
+	int32_t _speedRef;              /**< Toc do tham chieu sau doc (RPM) */
+	int32_t _accelRef;              /**< Gia toc tham chieu (RPM/s) */
+	uint16_t _accelerationLimit;    /**< Gioi han tang toc (RPM/s), 0 = khong doc */
+	uint16_t _decelerationLimit;    /**< Gioi han giam toc (RPM/s), 0 = khong doc */
+	int32_t _ffKv;                  /**< Feed-forward van toc, Q16 output / RPM */
+	int32_t _ffKa;                  /**< Feed-forward gia toc, Q16 output / (RPM/s) */
+	int32_t _ffStatic;              /**< Bu ma sat tinh (don vi output) */
+	int32_t _currentSpeed;          /**< Toc do do duoc (RPM) */
+	MoveProfile_t _profile;         /**< Bien dang hinh thang (POSITION) */
+	int32_t _position;              /**< Vi tri nhieu vong (xung x4), tich luy tu encoder */
+	int32_t _encoderCount;          /**< Bo dem encoder lan doc truoc */
+	int32_t _positionRef;           /**< Vi tri tham chieu tu bien dang (xung) */
+	int32_t _posKp;                 /**< Gain vong vi tri, Q16 RPM / xung */
+	bool _queueStreaming;           /**< Dang chay doan lay tu MotionQueue */
+	bool _queueStarved;             /**< Doan dang phanh khi hang doi can (cho underflow) */
+	int32_t _gearMasterOrigin;      /**< GEARED: vi tri Motor 1 luc vao khop */
+	int32_t _gearSlaveOrigin;       /**< GEARED: vi tri Motor 2 luc vao khop (da tru offset) */
+	uint16_t _gearSource;           /**< Nguon dang dung, 0xFFFF = chua vao khop */
+	volatile int32_t _currentRef;   /**< Dong dat (mA) tu vong toc do */
+	volatile int32_t _current;      /**< Dong do duoc (mA), co dau theo huong */
+	volatile int16_t _output;       /**< Duty dang xuat (Q15, co dau) */
 
 	/* Cam bien */
-	float _distanceSensorValue;     /**< Gia tri khoang cach (cm), duoc cap nhat tu ben ngoai */
+	int32_t _distanceSensorValue;   /**< Gia tri khoang cach (cm), cap nhat moi tick tu Proximity */
 
 	/* Khoang cach an toan */
-	float _safeDistance;            /**< Khoang cach an toan (cm) */
+	int32_t _safeDistance;          /**< Khoang cach an toan (cm), REG_PROX_SAFE */
 
 	/* Thong so PWM */
-	float _maxDuty;                 /**< Gia tri PWM toi da */
+	int16_t _maxDuty;               /**< Gia tri PWM toi da (Q15) */
+	int16_t _dutyLimit;             /**< Tran duty do mo hinh nhiet (mode duty), <= _maxDuty */
+	uint16_t _thermalLimit;         /**< Dong cho phep theo mo hinh nhiet (mA) */
+	bool _stallReduced;             /**< Sau ket (REDUCE): chay tiep voi gioi han reduce_pct */
+	bool _braking;                  /**< Dang ham dong nang sau ket (BRAKE) */
+	bool _stopping;                 /**< Dang dung co kiem soat (STOP_MODE_DECEL), van _enabled */
+	uint16_t _stopTicks;            /**< So tick tu khi toc do dat ve 0 */
+	bool _onOffDemand;              /**< ONOFF: lenh bat sau tre (nho giua on_level / off_level) */
+	volatile bool _proxHeld;        /**< Dang giu output = 0 do vat can trong _safeDistance */
 
 	/* Trang thai he thong */
 	int _direction;
 	/**< Huong quay */
 	int _status;
-	/**< Trang thai dong co */
-
-
-
-	void (*Update)(struct _MotorDC *motor);
+	/**< Trang thai dong co (MOTOR_STATUS_x) */
+
+	/* Gia tri register da ap dung (phat hien master ghi moi) */
+	uint16_t _kp, _ki, _kd;
+	uint16_t _curKp, _curKi, _currentLimit;
+	uint16_t _encoderPpr;
+	uint16_t _ffKvReg, _ffKaReg, _ffStaticReg;
+	uint16_t _schedSource, _schedCount;
+	uint16_t _posKpReg, _posPpr;
+	tGainSchedulePoint _schedPoints[GAIN_SCHED_MAX_POINTS];
+	uint16_t _linEnable, _linDeadband;
+	uint16_t _linTable[LINEAR_LUT_POINTS];
 } MotorControl_t;
 
 typedef struct {
 	MotorControl_t motor1;
 	MotorControl_t motor2;
-	uint8_t system_status;    // 0 = Idle, 1 = Running, 2 = Fault
+	uint8_t system_status;    // 0 = Idle, 1 = Running, 2 = Fault (tong hop tu MotorState)
 	uint8_t error_code;       // Mã lỗi nếu có
+	volatile int32_t gear_correction;  // RPM cong vao toc do dat Motor 1 khi Motor 2 GEARED bi tre
 } DriverSystem_t;
 
-typedef struct {
-    // Motor 1
-    uint16_t m1_target_speed;
-    uint16_t m1_actual_speed;
-    uint16_t m1_direction;
-    uint16_t m1_pid_kp;
-    uint16_t m1_pid_ki;
-    uint16_t m1_pid_kd;
-
-    // Motor 2
-    uint16_t m2_target_speed;
-    uint16_t m2_actual_speed;
-    uint16_t m2_direction;
-    uint16_t m2_pid_kp;
-    uint16_t m2_pid_ki;
-    uint16_t m2_pid_kd;
-
-    // System
-    uint16_t system_status;
-    uint16_t error_code;
-} ModbusRegisterMap_t;
-
 extern DriverSystem_t driver;
-extern ModbusRegisterMap_t modbus_map;
+
+#define MOTOR_CONTROL(id)       ((id) == 0 ? &driver.motor1 : &driver.motor2)
 
 void _motorInit();
-void _setRuningMode(ModbusRegisterMap_t *modbus_map, DriverSystem_t *driver);
-void _setEnableMotor(DriverSystem_t *driver);
-void _setDisableMotor(DriverSystem_t *driver);
-void _setOnOffMode(ModbusRegisterMap_t *modbus_map, DriverSystem_t *driver);
-void _setLinearMode(ModbusRegisterMap_t *modbus_map, DriverSystem_t *driver);
-void _setPIDMode(ModbusRegisterMap_t *modbus_map, DriverSystem_t *driver);
-
-void _runOnOffMode(DriverSystem_t *driver);
-void _runLinearMode(DriverSystem_t *driver);
-void _runPIDMode(DriverSystem_t *driver);
-
-void _updateMotor(DriverSystem_t *driver);
+void _setRuningMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setEnableMotor(MotorControl_t *motor);
+void _setDisableMotor(MotorControl_t *motor);
+void _setOnOffMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setLinearMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setPIDMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setCascadeMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setPositionMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setGearedMode(tMotorRegisters *regs, MotorControl_t *motor);
+void _setDiffDriveMode(tMotorRegisters *regs, MotorControl_t *motor);
+
+void _runOnOffMode(MotorControl_t *motor);
+void _runLinearMode(MotorControl_t *motor);
+void _runPIDMode(MotorControl_t *motor);
+void _runCascadeMode(MotorControl_t *motor);
+void _runPositionMode(MotorControl_t *motor);
+void _runGearedMode(MotorControl_t *motor);
+void _runDiffDriveMode(MotorControl_t *motor);
+
+/**
+ * @brief Duong lay mau dong (ISR CurrentSense moi tick nhanh): do dong, uoc luong
+ *        back-EMF, vong dong dien (CASCADE)
+ */
+void _runCurrentLoop(MotorControl_t *motor);
+
+/**
+ * @brief Mot chu ky dieu khien 1 kHz (goi tu Motor1_Task / Motor2_Task)
+ */
+void _updateMotor(MotorControl_t *motor);
 #endif
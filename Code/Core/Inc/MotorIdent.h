@@ -0,0 +1,52 @@
+/*
+ * MotorIdent.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_MOTORIDENT_H_
+#define INC_MOTORIDENT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "MotorIdentFit.h"
+
+typedef enum {
+    IDENT_IDLE = 0,
+    IDENT_STEP = 1,         /**< Buoc dien ap, ghi dong nhanh (R, L) va toc do */
+    IDENT_RAMP = 2,         /**< Duty doc len / xuong (Ke, J, ma sat) */
+    IDENT_DONE = 3,
+    IDENT_FAILED = 4
+} MotorIdent_State_t;
+
+/**
+ * @brief Bat dau nhan dang (motor phai dang tat, dung yen)
+ *
+ * Dung chung mot buffer RAM: chi mot motor nhan dang tai mot thoi diem.
+ * @param step_duty Buoc duty (Q15, > 0)
+ * @param has_speed Co phan hoi toc do doc lap (encoder); khong co thi chi do R, L
+ * @return false neu buffer dang ban
+ */
+bool MotorIdent_Start(uint8_t motor, int16_t step_duty, uint16_t vbus_mv, bool has_speed);
+
+void MotorIdent_Abort(uint8_t motor);
+
+/**
+ * @brief Mot chu ky dieu khien (1 kHz, task): ghi mau, tra ve duty can xuat (Q15)
+ *
+ * Khi het chuoi thu, giai binh phuong toi thieu ngay trong task (mot lan,
+ * MotorIdent_Fit() - khong nam trong vong dieu khien).
+ */
+int16_t MotorIdent_Step(uint8_t motor, int32_t current_ma, int32_t speed_rpm);
+
+/**
+ * @brief Ghi mau dong o tan so vong nhanh (ISR CurrentSense) luc dau buoc dien ap
+ */
+void MotorIdent_FastSample(uint8_t motor, int32_t current_ma);
+
+MotorIdent_State_t MotorIdent_GetState(uint8_t motor);
+
+bool MotorIdent_GetResult(uint8_t motor, MotorIdent_Result_t *out);
+
+#endif /* INC_MOTORIDENT_H_ */
@@ -0,0 +1,62 @@
+/*
+ * MotorIdentFit.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_MOTORIDENTFIT_H_
+#define INC_MOTORIDENTFIT_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Thong so uoc luong (don vi register)
+ *
+ * J va ma sat quy ve dong dien tuong duong (chia cho Kt de ra don vi SI):
+ * I = J * dw/dt + Fv * w + Fc.
+ */
+typedef struct {
+    uint16_t r_mohm;
+    uint16_t l_uh;
+    uint16_t ke_uv_per_rpm;     /**< 0 neu khong co phan hoi toc do */
+    uint16_t j_ua_s_per_rpm;    /**< uA / (RPM/s) */
+    uint16_t fv_ua_per_rpm;     /**< Ma sat nhot, uA / RPM */
+    uint16_t fc_ma;             /**< Ma sat Coulomb, mA */
+} MotorIdent_Result_t;
+
+/**
+ * @brief Mot mau cham (moi CONFIG_IDENT_DECIMATION chu ky dieu khien)
+ */
+typedef struct {
+    int16_t duty;               /**< Duty da sinh ra dong / toc do nay (Q15) */
+    int16_t current_ma;
+    int16_t speed_rpm;
+} MotorIdent_Sample_t;
+
+/**
+ * @brief Du lieu ghi duoc trong mot lan nhan dang
+ */
+typedef struct {
+    const int16_t *fast;                /**< Dong (mA) o tan so vong nhanh tu dau buoc dien ap */
+    uint16_t fast_count;
+    uint32_t fast_hz;
+    const MotorIdent_Sample_t *slow;    /**< Buoc + doc len / xuong */
+    uint16_t slow_count;
+    uint32_t slow_period_ms;
+    int16_t  step_duty;                 /**< Q15 */
+    uint16_t vbus_mv;
+    bool     has_speed;                 /**< false: chi giai R, L */
+} MotorIdent_Capture_t;
+
+/**
+ * @brief Giai binh phuong toi thieu tren du lieu da ghi
+ *
+ * Thuan tinh toan (float mem, khong HAL): chay trong task mot lan sau chuoi
+ * thu, hoac tren may host voi du lieu tong hop (Code/Test).
+ * @return false neu du lieu khong du kich thich (ma tran suy bien, R / Ke <= 0)
+ */
+bool MotorIdent_Fit(const MotorIdent_Capture_t *cap, MotorIdent_Result_t *res);
+
+#endif /* INC_MOTORIDENTFIT_H_ */
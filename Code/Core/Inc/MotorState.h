@@ -0,0 +1,87 @@
+/*
+ * MotorState.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_MOTORSTATE_H_
+#define INC_MOTORSTATE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ModbusMap.h"
+
+/**
+ * @brief Trang thai tung motor (gia tri ghi ra REG_MSM_Mx_STATE)
+ *
+ * Log giu MOTOR_STATE_LOG_DEPTH lan chuyen gan nhat cua ca hai motor.
+ */
+typedef enum {
+    MOTOR_STATE_DISABLED = 0,       /**< Output tat, khong co lenh chay */
+    MOTOR_STATE_READY = 1,          /**< Da bat nhung giu output = 0 (vat can trong vung an toan) */
+    MOTOR_STATE_RUNNING = 2,        /**< Output theo mode dang chon */
+    MOTOR_STATE_STOPPING = 3,       /**< Dung co kiem soat (STOP_MODE_DECEL) */
+    MOTOR_STATE_FAULT = 4,          /**< Loi da chot, output tat, cho reset */
+    MOTOR_STATE_RECOVERING = 5,     /**< Ket rotor, dang cho tu thu lai (STALL_REACTION_RETRY) */
+    MOTOR_STATE_COUNT
+} MotorState_t;
+
+/**
+ * @brief Su kien gay chuyen trang thai (ghi vao log)
+ */
+typedef enum {
+    MOTOR_EVENT_ENABLE = 0,         /**< Bat output theo mode */
+    MOTOR_EVENT_DISABLE = 1,        /**< Tat ngay (tha troi / ham) */
+    MOTOR_EVENT_STOP = 2,           /**< Bat dau dung co kiem soat */
+    MOTOR_EVENT_STOPPED = 3,        /**< Dung co kiem soat xong */
+    MOTOR_EVENT_FAULT = 4,          /**< Loi chot */
+    MOTOR_EVENT_BACKOFF = 5,        /**< Bat dau cho thu lai sau ket */
+    MOTOR_EVENT_RESET = 6,          /**< Loi da xoa (master reset) */
+    MOTOR_EVENT_HOLD = 7,           /**< Vat can: giu output = 0 */
+    MOTOR_EVENT_RELEASE = 8,        /**< Het vat can: chay lai */
+    MOTOR_EVENT_MODE = 9,           /**< Doi mode khi dang bat (khong dung motor) */
+    MOTOR_EVENT_COUNT
+} MotorEvent_t;
+
+/**
+ * @brief Mot dong log chuyen trang thai
+ */
+typedef struct {
+    uint32_t time_ms;               /**< osKernelGetTickCount() luc chuyen */
+    uint8_t motor;
+    uint8_t from;                   /**< MotorState_t */
+    uint8_t to;                     /**< MotorState_t */
+    uint8_t mode;                   /**< MotorMode_t sau khi chuyen */
+    uint8_t event;                  /**< MotorEvent_t */
+} MotorState_LogEntry_t;
+
+void MotorState_Init(void);
+
+/**
+ * @brief Trang thai dich cho su kien tu trang thai hien tai (tra bang, O(1))
+ * @return MOTOR_STATE_COUNT neu su kien khong hop le o trang thai nay
+ */
+MotorState_t MotorState_Next(uint8_t motor, MotorEvent_t event);
+
+/**
+ * @brief Chuyen trang thai neu hop le, ghi log (ca chuyen ve chinh no, vd. doi mode)
+ *
+ * Goi tu task cua motor; log dung chung duoc ghi trong critical section.
+ * @param mode Mode dang chay sau khi chuyen (ghi vao log)
+ * @return false neu bang khong cho phep (trang thai giu nguyen, dem rejected)
+ */
+bool MotorState_Dispatch(uint8_t motor, MotorEvent_t event, uint8_t mode, uint32_t now_ms);
+
+MotorState_t MotorState_Get(uint8_t motor);
+
+/**
+ * @brief Dong log thu index, 0 = moi nhat
+ * @return false neu chua co dong nay
+ */
+bool     MotorState_GetLog(uint8_t index, MotorState_LogEntry_t *entry);
+uint16_t MotorState_GetTransitions(void);  /**< Tong so lan chuyen (dem vong) */
+uint16_t MotorState_GetRejected(void);     /**< Su kien bi bang tu choi (dem vong) */
+void     MotorState_ClearLog(void);
+
+#endif /* INC_MOTORSTATE_H_ */
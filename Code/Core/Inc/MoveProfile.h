@@ -0,0 +1,71 @@
+/*
+ * MoveProfile.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_MOVEPROFILE_H_
+#define INC_MOVEPROFILE_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Bien dang chuyen dong hinh thang (vi tri theo xung encoder x4)
+ *
+ * Vi tri / van toc / gia toc giu o Q24 theo don vi xung, xung/tick, xung/tick^2
+ * de gia toc nho (vai RPM/s, encoder it xung) van tich luy duoc o 1 kHz.
+ * Moi tick: giam toc khi quang duong con lai <= quang duong phanh, nguoc lai
+ * tang toc toi vmax. Quang duong ngan -> bien dang tam giac.
+ */
+typedef struct {
+    int64_t pos_q24;
+    int64_t vel_q24;        /**< Co dau */
+    int64_t target_q24;
+    int64_t vmax_q24;       /**< > 0 */
+    int64_t accel_q24;      /**< > 0 */
+    uint32_t counts_per_rev;
+    uint32_t loop_hz;
+    uint16_t accel_rpm_s;
+    int8_t accel_sign;      /**< Huong gia toc cua tick vua roi (-1, 0, 1) */
+    bool done;
+} MoveProfile_t;
+
+/**
+ * @brief Dung yen tai position (done)
+ */
+void    MoveProfile_Reset(MoveProfile_t *profile, int32_t position);
+
+/**
+ * @brief Bat dau di chuyen toi target tu trang thai hien tai (ke ca dang chay)
+ * @param vmax_rpm      Van toc toi da (RPM), 0 = khong chay
+ * @param accel_rpm_s   Gia toc / giam toc (RPM/s), 0 = dat vmax trong 1 tick
+ * @param counts_per_rev Xung x4 moi vong (4 * PPR)
+ */
+void    MoveProfile_Start(MoveProfile_t *profile, int32_t target, uint16_t vmax_rpm,
+                          uint16_t accel_rpm_s, uint32_t counts_per_rev, uint32_t loop_hz);
+
+/**
+ * @brief Dung co kiem soat: target moi = diem dung voi gia toc hien tai
+ */
+void    MoveProfile_Stop(MoveProfile_t *profile);
+
+/**
+ * @brief Mot tick cua bien dang
+ * @return Vi tri tham chieu (xung)
+ */
+int32_t MoveProfile_Update(MoveProfile_t *profile);
+
+int32_t MoveProfile_GetPosition(const MoveProfile_t *profile);
+int32_t MoveProfile_GetTarget(const MoveProfile_t *profile);
+int32_t MoveProfile_GetVelocity(const MoveProfile_t *profile);     /**< RPM */
+int32_t MoveProfile_GetAccel(const MoveProfile_t *profile);        /**< RPM/s */
+bool    MoveProfile_IsDone(const MoveProfile_t *profile);
+
+/**
+ * @brief Dang giam toc ve target (da qua diem bat dau phanh)
+ */
+bool    MoveProfile_IsDecelerating(const MoveProfile_t *profile);
+
+#endif /* INC_MOVEPROFILE_H_ */
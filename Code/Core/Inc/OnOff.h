@@ -0,0 +1,56 @@
+/*
+ * OnOff.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_ONOFF_H_
+#define INC_ONOFF_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Thong so che do ON/OFF (don vi register)
+ */
+typedef struct {
+    uint16_t on_duty_pm;        /**< Duty khi bat (phan nghin) */
+    uint16_t soft_start_ms;     /**< Doc duty 0 -> on_duty, 0 = bat ngay */
+    uint16_t min_on_ms;         /**< Da bat thi giu it nhat bay lau */
+    uint16_t min_off_ms;        /**< Da tat thi cho it nhat bay lau moi bat lai */
+} OnOff_Params_t;
+
+typedef enum {
+    ONOFF_STATE_OFF = 0,
+    ONOFF_STATE_SOFT_START = 1, /**< Dang doc duty len */
+    ONOFF_STATE_ON = 2,
+    ONOFF_STATE_HOLD_OFF = 3,   /**< Co lenh bat, dang cho het min_off */
+    ONOFF_STATE_HOLD_ON = 4,    /**< Het lenh bat, dang cho het min_on */
+} OnOff_State_t;
+
+/**
+ * @brief Cau H da ngat tu ben ngoai (tat motor, loi, doi mode)
+ *
+ * Dang chay: tinh thoi gian tat tu now de min_off van ap dung khi bat lai.
+ */
+void OnOff_Stop(uint8_t motor, uint32_t now_ms);
+
+/**
+ * @brief Tiep quan output dang chay (doi mode khi motor dang quay)
+ *
+ * Lui moc thoi gian bat de soft-start tiep tuc tu duty hien tai thay vi tu 0.
+ * @param duty Duty dang xuat (Q15, >= 0), 0 = bat binh thuong o tick sau
+ */
+void OnOff_Resume(uint8_t motor, const OnOff_Params_t *params, int32_t duty, uint32_t now_ms);
+
+/**
+ * @brief Mot chu ky dieu khien (O(1))
+ * @param demand Lenh bat da qua tre (nguon register / gia tri / chan IN)
+ * @return Duty (Q15, >= 0)
+ */
+int32_t OnOff_Update(uint8_t motor, const OnOff_Params_t *params, bool demand, uint32_t now_ms);
+
+OnOff_State_t OnOff_GetState(uint8_t motor);
+
+#endif /* INC_ONOFF_H_ */
@@ -8,6 +8,70 @@
 #ifndef INC_PID_H_
 #define INC_PID_H_
 
+#include <stdint.h>
 
+/**
+ * @brief Bo gain da quy doi (cung don vi voi PID_t)
+ */
+typedef struct {
+    int32_t kp;                 /**< Q16 */
+    int32_t ki;                 /**< Q24 */
+    int32_t kd;                 /**< Q16 */
+} PID_Gains_t;
+
+/**
+ * @brief Bo PID so nguyen, dung chung cho vong toc do va vong dong dien
+ *
+ * Gain da quy doi theo chu ky mau (xem FP_RatioQ):
+ *  kp: Q16, output / don vi sai so
+ *  ki: Q24, output / (don vi sai so * mau)
+ *  kd: Q16, output / (thay doi do luong moi mau) - D tren do luong, khong giat khi doi setpoint
+ * Chong bao hoa tich phan: ngung tich phan khi output da bao hoa cung chieu sai so,
+ * tich phan luon nam trong [out_min, out_max].
+ */
+typedef struct {
+    int32_t kp;
+    int32_t ki;
+    int32_t kd;
+    int64_t integral;           /**< Q24, don vi output */
+    int32_t prev_measurement;
+    int32_t prev_error;
+    int32_t out_min;
+    int32_t out_max;
+    int32_t output;
+} PID_t;
+
+void    PID_Init(PID_t *pid, int32_t out_min, int32_t out_max);
+void    PID_SetGains(PID_t *pid, int32_t kp_q16, int32_t ki_q24, int32_t kd_q16);
+/**
+ * @brief Doi gain khi dang chay ma output khong giat
+ *
+ * Phan P thay doi (kp cu - kp moi) * sai so cuoi duoc bu vao tich phan.
+ */
+void    PID_SetGainsBumpless(PID_t *pid, int32_t kp_q16, int32_t ki_q24, int32_t kd_q16);
+void    PID_SetLimits(PID_t *pid, int32_t out_min, int32_t out_max);
+
+/**
+ * @brief Dat lai trang thai, tich phan = output (chuyen che do khong giat)
+ */
+void    PID_Reset(PID_t *pid, int32_t measurement, int32_t output);
+
+/**
+ * @brief Bam theo output dang xuat boi nguon khac (back-calculation)
+ *
+ * Tich phan = output - P - feed-forward, nen PID_UpdateFF() ke tiep voi cung
+ * setpoint / do luong tra ve dung output: chuyen tu mode khac sang khong giat.
+ */
+void    PID_Track(PID_t *pid, int32_t setpoint, int32_t measurement, int32_t feedforward, int32_t output);
+
+/**
+ * @brief Mot buoc PID, O(1), khong chia - an toan trong ISR
+ */
+int32_t PID_Update(PID_t *pid, int32_t setpoint, int32_t measurement);
+
+/**
+ * @brief Nhu PID_Update, cong them feed-forward (don vi output) truoc bao hoa
+ */
+int32_t PID_UpdateFF(PID_t *pid, int32_t setpoint, int32_t measurement, int32_t feedforward);
 
 #endif /* INC_PID_H_ */
@@ -0,0 +1,125 @@
+/*
+ * PWM.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_PWM_H_
+#define INC_PWM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PWM_DUTY_MAX    32767   /**< 100% duty, Q15 */
+
+typedef enum {
+    PWM_ALIGN_EDGE = 0,         /**< Edge-aligned, up-counting */
+    PWM_ALIGN_CENTER = 1        /**< Center-aligned mode 1 */
+} PWM_Align_t;
+
+typedef enum {
+    PWM_OUTPUT_MODE_SINGLE = 0,         /**< Chi chan PWM, thoi gian tat dong chay qua diode */
+    PWM_OUTPUT_MODE_COMPLEMENTARY = 1   /**< Them khoa duoi dao pha co dead-time (chinh luu dong bo) */
+} PWM_OutputMode_t;
+
+/**
+ * @brief Start PWM tren TIM1 CH1 / TIM3 CH3 voi cau hinh mac dinh
+ *
+ * Goi sau MX_TIM1_Init() / MX_TIM3_Init()
+ */
+void PWM_Init(void);
+
+/**
+ * @brief Doi tan so / kieu dieu che PWM cho ca hai kenh
+ *
+ * Prescaler duoc chon nho nhat co the de ARR lon nhat (do phan giai duty
+ * cao nhat). PSC, ARR va CCR deu o che do preload nen chi co hieu luc o
+ * update event tiep theo. Doi edge <-> center can dung counter mot chu ky.
+ *
+ * @param freq_hz Tan so PWM (CONFIG_PWM_FREQUENCY_MIN_HZ..MAX_HZ)
+ * @param align   Kieu dieu che
+ * @return false neu tham so khong hop le (cau hinh cu duoc giu nguyen)
+ */
+bool PWM_Configure(uint32_t freq_hz, PWM_Align_t align);
+
+/**
+ * @brief Chon output don / bu cho ca hai kenh
+ *
+ * TIM1 (Motor 2): CH1N (PB13) qua bo chen dead-time phan cung (BDTR.DTG).
+ * TIM3 (Motor 1): khong co CHxN, gia lap bang CH2 (PB5, partial remap) o
+ * che do PWM2 voi CCR2 = CCR3 + dead-time; chi dung duoc o center-aligned,
+ * edge-aligned giu output don. Duty 0: ca hai khoa tat (motor tha troi).
+ *
+ * @param dead_time_ns Lam tron len theo buoc DTG cua TIM1 (toi da 1008 tick)
+ * @return false neu mode hoac dead-time khong hop le (cau hinh cu duoc giu nguyen)
+ */
+bool PWM_SetOutputMode(PWM_OutputMode_t mode, uint32_t dead_time_ns);
+
+/**
+ * @brief Hau xu ly duty cho ca hai kenh
+ *
+ * Xung bat ngan hon min_pulse_ns (vd. opto 6N136 khong kip dan) bi bo
+ * hoac keo dai thanh min_pulse_ns; tuong tu voi xung tat khi duty gan 100 %.
+ * dither: sai so (phan bi bo / keo dai va phan duoi mot buoc timer) don sang
+ * cac tick sau (sigma-delta bac 1) de duty trung binh dung voi lenh va do
+ * phan giai hieu dung cao hon ARR.
+ *
+ * @param min_pulse_ns 0 = tat, gioi han toi da 1/4 chu ky PWM
+ */
+void PWM_SetPostProcess(uint32_t min_pulse_ns, bool dither);
+
+/**
+ * @brief Mot buoc sigma-delta (goi tu vong nhanh, CONFIG_CURRENT_LOOP_HZ)
+ *
+ * Tinh lai CCR tu duty da dat; moi tick keo dai PWM / CONFIG_CURRENT_LOOP_HZ
+ * chu ky PWM. Khong lam gi khi tat dither.
+ */
+void PWM_Dither(void);
+
+/**
+ * @brief Dat duty cho mot motor
+ * @param motor Chi so motor (0 = Motor 1, 1 = Motor 2)
+ * @param duty  Duty co dau Q15 (-PWM_DUTY_MAX..PWM_DUTY_MAX), dau = chieu quay
+ */
+void PWM_SetDuty(uint8_t motor, int16_t duty);
+
+/**
+ * @brief Ham dong nang: DIRx = DIRy = 0 (hai khoa duoi dan), PWM = strength
+ *
+ * Dong phan dien tu back-EMF chay vong qua cau H. Giu cho den lan
+ * PWM_SetDuty() tiep theo (duty != 0 dat lai chieu).
+ * @param strength Muc ham Q15 (0..PWM_DUTY_MAX)
+ */
+void PWM_Brake(uint8_t motor, int16_t strength);
+
+/**
+ * @brief Cat PWM ngay lap tuc (an toan trong ISR)
+ *
+ * TIM1: software break (EGR.BG) xoa MOE, output ve muc idle (OSSI).
+ * TIM3: khong co break, ep OC ve muc inactive va CCR = 0.
+ * Output giu tat cho den khi goi PWM_Resume().
+ */
+void PWM_EmergencyStop(void);
+
+/**
+ * @brief Bat lai PWM sau PWM_EmergencyStop(), duty ve 0
+ */
+void PWM_Resume(void);
+
+bool PWM_IsStopped(void);
+
+uint32_t    PWM_GetFrequency(void);
+PWM_Align_t PWM_GetAlign(void);
+PWM_OutputMode_t PWM_GetOutputMode(void);
+uint16_t    PWM_GetDeadTime(void);         /**< ns, sau khi lam tron */
+uint16_t    PWM_GetMinPulse(void);         /**< ns, 0 = tat */
+bool        PWM_GetDither(void);
+uint16_t    PWM_GetMinDuty(void);          /**< Duty nho nhat ra duoc (phan nghin chu ky) */
+
+/**
+ * @brief So buoc duty trong mot chu ky PWM (ARR + 1 hoac ARR)
+ */
+uint16_t    PWM_GetResolution(void);
+
+#endif /* INC_PWM_H_ */
@@ -0,0 +1,41 @@
+/*
+ * Protection.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_PROTECTION_H_
+#define INC_PROTECTION_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Khoi tao bao ve qua dong (ngat ADC1_2 uu tien cao nhat)
+ *
+ * Analog watchdog cua ADC1 giam sat moi lan chuyen doi dong dien (tat ca kenh
+ * trong scan). Khi vuot nguong, ISR cat PWM bang software break TIM1 (MOE = 0)
+ * va ep TIM3 ve inactive, khong cho den vong lap dieu khien.
+ */
+void Protection_Init(void);
+
+/**
+ * @brief Cap nhat bao ve (goi moi 1 ms tu defaultTask)
+ *
+ * Nap lai nguong watchdog khi REG_OCP_THRESHOLD_MA thay doi (sau khi
+ * CurrentSense da hieu chuan offset). Xu ly REG_RESET_ERROR_COMMAND: xoa loi
+ * da chot va bat lai PWM.
+ */
+void Protection_Update(void);
+
+/**
+ * @brief Handler ngat analog watchdog (goi tu ADC1_2_IRQHandler)
+ */
+void Protection_IRQHandler(void);
+
+/**
+ * @brief true neu dang co loi qua dong da chot (PWM bi cat)
+ */
+bool Protection_IsTripped(void);
+
+#endif /* INC_PROTECTION_H_ */
@@ -0,0 +1,49 @@
+/*
+ * Proximity.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_PROXIMITY_H_
+#define INC_PROXIMITY_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define PROXIMITY_SCALE_FULL    32768       /**< He so toc do Q15 = 1.0 */
+
+/**
+ * @brief Vung bao ve quanh cam bien khoang cach (don vi register)
+ *
+ * d <= safe_cm: dung han. safe_cm < d < slow_cm: toc do cho phep giam tuyen
+ * tinh tu 100 % xuong creep_pct. d >= slow_cm: khong gioi han.
+ */
+typedef struct {
+    uint16_t safe_cm;
+    uint16_t slow_cm;           /**< <= safe_cm: chi dung han, khong giam toc */
+    uint16_t creep_pct;         /**< Toc do con lai sat mep safe_cm (%) */
+    uint16_t timeout_ms;        /**< Nguon UART: khong co frame bay lau -> mat cam bien, 0 = bo qua */
+} Proximity_Params_t;
+
+/**
+ * @brief Mot tick dieu khien (goi tu mot task duy nhat)
+ *
+ * Doi nguon thi cau hinh lai USART1 (baud theo loai cam bien).
+ * @param source      PROXIMITY_SOURCE_x
+ * @param external_cm Khoang cach cho nguon REGISTER / PIN (cm)
+ */
+void     Proximity_Update(uint32_t now_ms, uint16_t source, const Proximity_Params_t *params,
+                          uint16_t external_cm);
+
+/**
+ * @brief Xu ly ngat USART1 (goi tu USART1_IRQHandler), giai ma frame cam bien
+ */
+void     Proximity_IRQHandler(void);
+
+uint16_t Proximity_GetDistance(void);      /**< cm, PROXIMITY_DISTANCE_FAR = khong co vat */
+int32_t  Proximity_GetScale(void);         /**< Q15, 0 = dung han */
+bool     Proximity_IsLost(void);
+uint16_t Proximity_GetFrames(void);        /**< So frame UART hop le (dem vong) */
+
+#endif /* INC_PROXIMITY_H_ */
@@ -0,0 +1,42 @@
+/*
+ * Ramp.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_RAMP_H_
+#define INC_RAMP_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Bo tao doc toc do (gioi han gia toc / giam toc)
+ *
+ * Gia tri giu o Q16 de buoc nho (vai RPM/s o 1 kHz) khong bi lam tron ve 0.
+ * Tang toc khi |ref| dang tang, giam toc khi |ref| dang ve 0 (ke ca doi chieu).
+ */
+typedef struct {
+    int64_t value_q16;      /**< Toc do tham chieu (RPM, Q16) */
+    int32_t accel;          /**< Gia toc tham chieu cua buoc vua roi (RPM/s) */
+} Ramp_t;
+
+void    Ramp_Reset(Ramp_t *ramp, int32_t value);
+
+/**
+ * @brief Mot buoc doc
+ * @param accel_limit Gioi han tang toc (RPM/s), 0 = khong gioi han
+ * @param decel_limit Gioi han giam toc (RPM/s), 0 = khong gioi han
+ * @return Toc do tham chieu (RPM)
+ */
+int32_t Ramp_Update(Ramp_t *ramp, int32_t target, uint32_t accel_limit,
+                    uint32_t decel_limit, uint32_t loop_hz);
+
+int32_t Ramp_GetValue(const Ramp_t *ramp);
+
+/**
+ * @brief Dao ham cua tham chieu (RPM/s), dung cho feed-forward gia toc
+ */
+int32_t Ramp_GetAccel(const Ramp_t *ramp);
+
+#endif /* INC_RAMP_H_ */
@@ -0,0 +1,78 @@
+/*
+ * Stall.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_STALL_H_
+#define INC_STALL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Nguong phat hien ket rotor (don vi register)
+ */
+typedef struct {
+    uint16_t current_ma;        /**< |I| >= nguong */
+    uint16_t speed_rpm;         /**< |toc do| <= nguong */
+    uint16_t duty_pm;           /**< |duty| >= nguong (phan nghin) */
+    uint16_t time_ms;           /**< Ca ba dieu kien lien tuc trong bay lau */
+    uint16_t retry_delay_ms;    /**< Thoi gian cho truoc lan thu lai dau tien */
+    uint16_t retry_max;         /**< So lan thu lai toi da */
+} Stall_Params_t;
+
+typedef enum {
+    STALL_STATE_OK = 0,
+    STALL_STATE_STALLED = 1,    /**< Da chot, cho reset loi */
+    STALL_STATE_BACKOFF = 2,    /**< Cho het thoi gian truoc khi thu lai */
+} Stall_State_t;
+
+/**
+ * @brief Ve STALL_STATE_OK, xoa bo dem cua so va so lan thu lai
+ */
+void Stall_Reset(uint8_t motor);
+
+/**
+ * @brief Mot tick 1 kHz khi motor dang chay (O(1))
+ * @param duty Duty dang xuat (Q15, co dau)
+ * @return true o tick xac nhan ket (state -> STALLED, count + 1)
+ */
+bool Stall_Check(uint8_t motor, const Stall_Params_t *params,
+                 int32_t current_ma, int32_t speed_rpm, int32_t duty);
+
+/**
+ * @brief Chuyen sang cho thu lai (sau Stall_Check() == true)
+ *
+ * Het luot thu lai: giu STALLED.
+ */
+void Stall_StartBackoff(uint8_t motor, const Stall_Params_t *params);
+
+/**
+ * @brief Ghi MOTOR_ERR_STALL vao ma loi motor (sau Stall_Check() == true)
+ *
+ * Chi ghi khi chua co loi nao: OVERCURRENT do ISR analog watchdog dat cung
+ * tick duoc giu nguyen, bo dem ket ve OK (khong phan ung ket).
+ * @param error REG_Mx_ERROR_CODE
+ * @return true neu da ghi STALL (tiep tuc phan ung theo REG_Mx_STALL_REACTION)
+ */
+bool Stall_Latch(uint8_t motor, uint16_t *error);
+
+/**
+ * @brief Mot tick 1 kHz trong BACKOFF
+ *
+ * Het thoi gian cho: chi xoa loi khi loi van la STALL va qua dong khong chot.
+ * Loi khac xuat hien trong luc cho (OCP): Stall_Reset(), loi giu nguyen, motor
+ * o FAULT den khi master reset loi.
+ * @param error REG_Mx_ERROR_CODE
+ * @param ocp_tripped Protection_IsTripped()
+ * @return true khi thu lai (error -> NONE, state -> OK, retries + 1)
+ */
+bool Stall_RetryDue(uint8_t motor, uint16_t *error, bool ocp_tripped);
+
+Stall_State_t Stall_GetState(uint8_t motor);
+uint16_t      Stall_GetCount(uint8_t motor);      /**< So lan ket tu khi khoi dong */
+uint16_t      Stall_GetRetries(uint8_t motor);
+
+#endif /* INC_STALL_H_ */
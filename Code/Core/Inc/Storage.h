@@ -0,0 +1,29 @@
+/*
+ * Storage.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_STORAGE_H_
+#define INC_STORAGE_H_
+
+#include <stdbool.h>
+
+/**
+ * @brief Nap cac register tham so tu trang flash cuoi (CONFIG_STORAGE_FLASH_ADDR)
+ *
+ * Goi luc khoi dong, truoc khi task chay. Anh khong hop le (magic, so word,
+ * CRC) bi bo qua, register giu gia tri mac dinh trong ModbusMap.c.
+ */
+void Storage_Load(void);
+
+/**
+ * @brief Ghi cac register tham so vao flash
+ *
+ * Xoa trang (~20-40 ms) lam CPU dung doc lenh tu flash, ke ca ISR: chi goi khi
+ * moi motor da tat.
+ */
+bool Storage_Save(void);
+
+#endif /* INC_STORAGE_H_ */
@@ -8,6 +8,20 @@
 #ifndef INC_SYSTEMSTATUS_H_
 #define INC_SYSTEMSTATUS_H_
 
+/**
+ * @brief Khoi tao cac system register chi doc (clock, PWM)
+ */
+void SystemStatus_Init(void);
 
+/**
+ * @brief Dong bo system registers voi phan cung (goi moi 1 ms tu defaultTask)
+ *
+ * Ap dung cau hinh PWM moi khi master ghi REG_PWM_FREQUENCY_KHZ /
+ * REG_PWM_ALIGN_MODE. Gia tri khong hop le bi tra ve cau hinh dang chay.
+ * Cap nhat bao ve qua dong (nguong, reset loi - xem Protection.h).
+ * Luu tham so vao flash khi REG_PARAM_SAVE = 1 (xem Storage.h).
+ * Publish dong dien motor (mA) vao REG_M1_CURRENT / REG_M2_CURRENT.
+ */
+void SystemStatus_Update(void);
 
 #endif /* INC_SYSTEMSTATUS_H_ */
@@ -0,0 +1,50 @@
+/*
+ * Thermal.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_THERMAL_H_
+#define INC_THERMAL_H_
+
+#include <stdint.h>
+
+/**
+ * @brief Thong so mo hinh nhiet cua motor (don vi register)
+ *
+ * Cau H dung hang so CONFIG_BRIDGE_x (Config.h).
+ */
+typedef struct {
+    uint16_t motor_rated_ma;    /**< Dong lien tuc cua motor (mA), 0 = khong mo hinh motor */
+    uint16_t motor_tau_s;       /**< Hang so thoi gian nhiet motor (s), 0 = khong mo hinh motor */
+    uint16_t horizon_ms;        /**< Thoi gian du bao khi giam dong (ms), 0 = chi theo doi */
+} Thermal_Params_t;
+
+/**
+ * @brief Nap thong so, tinh truoc he so dt/tau theo tan so vong nhanh
+ *
+ * Goi tu task moi chu ky dieu khien; khong lam gi neu thong so khong doi.
+ */
+void     Thermal_Configure(uint8_t motor, const Thermal_Params_t *params, uint32_t loop_hz);
+
+/**
+ * @brief Mot buoc I2t cho motor va cau H, goi trong ISR CurrentSense moi tick nhanh
+ *
+ * heat += (I^2 - heat) * dt / tau: loc thong thap bac 1 cua I^2, heat = I_rated^2
+ * la nhiet do on dinh khi chay lien tuc o dong dinh muc (100 %).
+ */
+void     Thermal_Update(uint8_t motor, int32_t current_ma);
+
+/**
+ * @brief Dong cho phep (mA) de heat khong vuot 100 % trong horizon_ms
+ *
+ * I^2 <= heat + (I_rated^2 - heat) * tau / horizon, lay gia tri nho nhat cua
+ * motor va cau H, khong qua CONFIG_BRIDGE_PEAK_MA. Nguoi => giam dan ve I_rated.
+ */
+uint16_t Thermal_GetAllowedCurrent(uint8_t motor);
+
+uint16_t Thermal_GetMotorPercent(uint8_t motor);    /**< % cua I_rated^2 */
+uint16_t Thermal_GetBridgePercent(uint8_t motor);
+
+#endif /* INC_THERMAL_H_ */
@@ -0,0 +1,76 @@
+/*
+ * Timing.h
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef INC_TIMING_H_
+#define INC_TIMING_H_
+
+#include "main.h"
+#include <stdint.h>
+
+/**
+ * @brief Clock tree snapshot, taken once after SystemClock_Config()
+ */
+typedef struct {
+    uint32_t sysclk_hz;       /**< SYSCLK as reported by HAL_RCC_GetSysClockFreq() */
+    uint32_t hclk_hz;         /**< AHB clock */
+    uint32_t pclk1_hz;        /**< APB1 clock (USART2, I2C1) */
+    uint32_t pclk2_hz;        /**< APB2 clock (USART1, ADC) */
+    uint32_t tim_apb1_hz;     /**< Kernel clock of TIM2/TIM3 */
+    uint32_t tim_apb2_hz;     /**< Kernel clock of TIM1 */
+    uint32_t current_loop_div;/**< PWM periods per fast loop tick */
+    uint32_t control_loop_div;/**< Fast loop ticks per speed loop tick */
+} Timing_t;
+
+extern Timing_t g_timing;
+
+/**
+ * @brief Chuyen sang profile SYSCLK chon boi CONFIG_SYSCLK_PROFILE
+ *
+ * SystemClock_Config() (Driver.ioc) luon dung profile 64 MHz HSI, khoi dong
+ * duoc khi khong co thach anh. Profile 72 MHz HSE chuyen PLL sang HSE; HSE
+ * khong len thi giu 64 MHz HSI. Goi trong USER CODE SysInit, truoc Timing_Init()
+ */
+void Timing_SelectClockProfile(void);
+
+/**
+ * @brief Doc lai clock tree va tinh cac he so chia
+ *
+ * Goi ngay sau SystemClock_Config(), truoc cac ham MX_TIMx_Init()
+ */
+void Timing_Init(void);
+
+uint32_t Timing_GetSysClockHz(void);
+
+/**
+ * @brief Tan so clock dau vao cua timer (da tinh he so x2 khi APB prescaler != 1)
+ */
+uint32_t Timing_GetTimerClockHz(const TIM_TypeDef *tim);
+
+/**
+ * @brief Gia tri ARR cho PWM edge-aligned voi prescaler = 0
+ * @return ARR (so buoc duty = ARR + 1), gioi han 16 bit
+ */
+uint32_t Timing_GetPwmPeriod(const TIM_TypeDef *tim, uint32_t freq_hz);
+
+/**
+ * @brief Prescaler de timer dem voi tan so 1 MHz (1 tick = 1 us)
+ */
+uint32_t Timing_GetMicrosecondPrescaler(const TIM_TypeDef *tim);
+
+/**
+ * @brief Thoi gian t3.5 cua Modbus RTU (us)
+ *
+ * 3.5 ky tu x 11 bit; tren 19200 baud dung gia tri co dinh 1750 us theo chuan
+ */
+uint32_t Timing_GetModbusT35Us(uint32_t baudrate);
+
+/**
+ * @brief He so chia de chay mot vong lap loop_hz tu nguon base_hz (toi thieu 1)
+ */
+uint32_t Timing_GetLoopDivider(uint32_t base_hz, uint32_t loop_hz);
+
+#endif /* INC_TIMING_H_ */
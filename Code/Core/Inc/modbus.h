@@ -31,14 +31,14 @@ void modbus_on_frame_timeout(void);
 
 /**
  * @brief Đọc giá trị từ holding register
- * @param reg_addr Địa chỉ register (0x0000 - 0x003F)
+ * @param reg_addr Địa chỉ register (0x0000 - TOTAL_REG_COUNT-1, xem ModbusMap.h)
  * @return Giá trị register (16-bit)
  */
 uint16_t modbus_read_register(uint16_t reg_addr);
 
 /**
  * @brief Ghi giá trị vào holding register
- * @param reg_addr Địa chỉ register (0x0000 - 0x003F)
+ * @param reg_addr Địa chỉ register (0x0000 - TOTAL_REG_COUNT-1, xem ModbusMap.h)
  * @param value Giá trị cần ghi (16-bit)
  */
 void modbus_write_register(uint16_t reg_addr, uint16_t value);
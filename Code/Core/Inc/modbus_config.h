@@ -35,10 +35,16 @@
 /**
  * @brief Số lượng holding registers tối đa
  * 
- * Phải đủ cho tất cả registers trong ModbusMap.h
- * Hiện tại: 0x0000-0x003F = 64 registers
+ * Bằng TOTAL_REG_COUNT trong ModbusMap.h (g_modbus_data)
  */
-#define MODBUS_MAX_REGISTERS  64
+#define MODBUS_MAX_REGISTERS  TOTAL_REG_COUNT
+
+/**
+ * @brief Số registers tối đa trong một request FC03/FC16
+ * 
+ * Giới hạn theo chuẩn Modbus, để response vừa MODBUS_BUFFER_SIZE
+ */
+#define MODBUS_MAX_QUANTITY   123
 
 /**
  * @brief Timeout cho frame (3.5 character time)
@@ -0,0 +1,155 @@
+/*
+ * AutoTune.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "AutoTune.h"
+#include "Config.h"
+#include "FixedPoint.h"
+
+#define AUTOTUNE_TOTAL_CYCLES   (CONFIG_AUTOTUNE_SKIP_CYCLES + CONFIG_AUTOTUNE_CYCLES)
+#define PI_NUM                  355     // pi ~ 355/113
+#define PI_DEN                  113
+
+typedef struct {
+    AutoTune_State_t state;
+    int32_t  setpoint;
+    int32_t  bias;
+    int32_t  amplitude;
+    int32_t  hysteresis;
+    int32_t  out_min;
+    int32_t  out_max;
+
+    bool     relay_high;
+    uint32_t elapsed_ms;            // 1 chu ky dieu khien = 1 ms
+    uint32_t last_rise_ms;
+    uint8_t  cycles;                // so canh len cua relay da dem
+    int32_t  peak_max;
+    int32_t  peak_min;
+
+    uint32_t sum_period_ms;
+    int32_t  sum_amplitude;         // tong (max - min) / 2, RPM
+    AutoTune_Result_t result;
+} AutoTune_t;
+
+static AutoTune_t tuners[MOTOR_COUNT];
+
+static uint16_t AutoTune_Clamp16(int64_t value) {
+    return (uint16_t)FP_Saturate(value, 0, UINT16_MAX);
+}
+
+static void AutoTune_Finish(AutoTune_t *t) {
+    int32_t tu = (int32_t)(t->sum_period_ms / CONFIG_AUTOTUNE_CYCLES);
+    int32_t a = t->sum_amplitude / CONFIG_AUTOTUNE_CYCLES;
+
+    if (a <= 0 || tu <= 0) {
+        t->state = AUTOTUNE_FAILED;
+        return;
+    }
+
+    // Ku = 4d / (pi a), don vi register x100
+    int64_t ku = ((int64_t)400 * t->amplitude * PI_DEN) / ((int64_t)PI_NUM * a);
+
+    // Ziegler-Nichols PID: Kp = 0.6 Ku, Ki = 1.2 Ku / Tu, Kd = 0.075 Ku Tu
+    t->result.ku = AutoTune_Clamp16(ku);
+    t->result.tu_ms = AutoTune_Clamp16(tu);
+    t->result.kp = AutoTune_Clamp16((ku * 6) / 10);
+    t->result.ki = AutoTune_Clamp16((ku * 1200) / tu);
+    t->result.kd = AutoTune_Clamp16((ku * 75 * tu) / 1000000);
+    t->state = AUTOTUNE_DONE;
+}
+
+void AutoTune_Start(uint8_t motor, int32_t setpoint, int32_t bias, int32_t amplitude,
+                    int32_t hysteresis, int32_t out_min, int32_t out_max) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    AutoTune_t *t = &tuners[motor];
+
+    t->setpoint = setpoint;
+    t->bias = bias;
+    t->amplitude = amplitude;
+    t->hysteresis = hysteresis;
+    t->out_min = out_min;
+    t->out_max = out_max;
+    t->relay_high = true;
+    t->elapsed_ms = 0;
+    t->last_rise_ms = 0;
+    t->cycles = 0;
+    t->peak_max = INT32_MIN;
+    t->peak_min = INT32_MAX;
+    t->sum_period_ms = 0;
+    t->sum_amplitude = 0;
+    t->state = (amplitude > 0) ? AUTOTUNE_RUNNING : AUTOTUNE_FAILED;
+}
+
+void AutoTune_Abort(uint8_t motor) {
+    if (motor < MOTOR_COUNT && tuners[motor].state == AUTOTUNE_RUNNING) {
+        tuners[motor].state = AUTOTUNE_IDLE;
+    }
+}
+
+int32_t AutoTune_Step(uint8_t motor, int32_t speed) {
+    AutoTune_t *t = &tuners[motor];
+
+    if (t->state != AUTOTUNE_RUNNING) {
+        return t->bias;
+    }
+    if (++t->elapsed_ms >= CONFIG_AUTOTUNE_TIMEOUT_MS) {
+        t->state = AUTOTUNE_FAILED;         // khong dao dong on dinh
+        return t->bias;
+    }
+
+    if (speed > t->peak_max) {
+        t->peak_max = speed;
+    }
+    if (speed < t->peak_min) {
+        t->peak_min = speed;
+    }
+
+    if (t->relay_high && speed > t->setpoint + t->hysteresis) {
+        t->relay_high = false;
+    } else if (!t->relay_high && speed < t->setpoint - t->hysteresis) {
+        t->relay_high = true;
+
+        // Canh len: ket thuc mot chu ky dao dong
+        if (t->cycles > CONFIG_AUTOTUNE_SKIP_CYCLES) {
+            t->sum_period_ms += t->elapsed_ms - t->last_rise_ms;
+            t->sum_amplitude += (t->peak_max - t->peak_min) / 2;
+        }
+        t->last_rise_ms = t->elapsed_ms;
+        t->peak_max = INT32_MIN;
+        t->peak_min = INT32_MAX;
+        if (++t->cycles > AUTOTUNE_TOTAL_CYCLES) {
+            AutoTune_Finish(t);
+            return t->bias;
+        }
+    }
+
+    return FP_Saturate((int64_t)t->bias + (t->relay_high ? t->amplitude : -t->amplitude),
+                       t->out_min, t->out_max);
+}
+
+AutoTune_State_t AutoTune_GetState(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? tuners[motor].state : AUTOTUNE_IDLE;
+}
+
+uint16_t AutoTune_GetProgress(uint8_t motor) {
+    if (motor >= MOTOR_COUNT) {
+        return 0;
+    }
+    if (tuners[motor].state == AUTOTUNE_DONE) {
+        return 100U;
+    }
+    return (uint16_t)((tuners[motor].cycles * 100U) / (AUTOTUNE_TOTAL_CYCLES + 1U));
+}
+
+bool AutoTune_GetResult(uint8_t motor, AutoTune_Result_t *out) {
+    if (motor >= MOTOR_COUNT || tuners[motor].state != AUTOTUNE_DONE) {
+        return false;
+    }
+    *out = tuners[motor].result;
+    return true;
+}
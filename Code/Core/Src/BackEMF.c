@@ -0,0 +1,90 @@
+/*
+ * BackEMF.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "BackEMF.h"
+#include "main.h"
+#include "Config.h"
+#include "FixedPoint.h"
+
+typedef struct {
+    BackEMF_Params_t params;    // thong so da nap (phat hien thay doi)
+    uint32_t loop_hz;
+    bool     enabled;
+
+    /* He so Q16, tinh trong task */
+    int32_t  r_q16;             // mV / mA
+    int32_t  l_q16;             // mV / (mA thay doi moi mau)
+    int32_t  inv_ke_q16;        // RPM / mV
+
+    /* Trang thai, chi ISR ghi */
+    int32_t  prev_current;
+    volatile int32_t speed_q8;  // RPM, Q8, da loc
+} BackEMF_t;
+
+static BackEMF_t estimators[MOTOR_COUNT];
+
+void BackEMF_Configure(uint8_t motor, const BackEMF_Params_t *params, uint32_t loop_hz) {
+    if (motor >= MOTOR_COUNT || loop_hz == 0U) {
+        return;
+    }
+    BackEMF_t *est = &estimators[motor];
+    if (est->loop_hz == loop_hz &&
+        est->params.r_mohm == params->r_mohm && est->params.l_uh == params->l_uh &&
+        est->params.ke_uv_per_rpm == params->ke_uv_per_rpm && est->params.vbus_mv == params->vbus_mv) {
+        return;
+    }
+
+    // R: mOhm -> mV/mA = R / 1000
+    int32_t r_q16 = FP_RatioQ(params->r_mohm, 1U, 1000U, 16);
+    // L*dI/dt: uH * (mA/mau * loop_hz) -> mV = L * loop_hz / 1e6
+    int32_t l_q16 = FP_RatioQ(params->l_uh, loop_hz, 1000000U, 16);
+    // w = EMF / Ke: mV / (uV/RPM) -> RPM = 1000 / Ke
+    int32_t inv_ke_q16 = (params->ke_uv_per_rpm != 0U) ?
+                         FP_RatioQ(1000, 1U, params->ke_uv_per_rpm, 16) : 0;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    est->params = *params;
+    est->loop_hz = loop_hz;
+    est->r_q16 = r_q16;
+    est->l_q16 = l_q16;
+    est->inv_ke_q16 = inv_ke_q16;
+    est->enabled = (params->ke_uv_per_rpm != 0U && params->vbus_mv != 0U);
+    est->speed_q8 = 0;
+    __set_PRIMASK(primask);
+}
+
+bool BackEMF_IsEnabled(uint8_t motor) {
+    return (motor < MOTOR_COUNT) && estimators[motor].enabled;
+}
+
+void BackEMF_Update(uint8_t motor, int32_t duty, int32_t current_ma) {
+    BackEMF_t *est = &estimators[motor];
+    if (!est->enabled) {
+        return;
+    }
+
+    int32_t v = (int32_t)(((int64_t)duty * est->params.vbus_mv) >> 15);
+    int32_t di = current_ma - est->prev_current;
+    est->prev_current = current_ma;
+
+    int64_t emf = (int64_t)v -
+                  (((int64_t)current_ma * est->r_q16) >> 16) -
+                  (((int64_t)di * est->l_q16) >> 16);
+    int32_t rpm_q8 = FP_Sat32((emf * est->inv_ke_q16) >> 8);
+
+    est->speed_q8 += (rpm_q8 - est->speed_q8) >> CONFIG_BACKEMF_FILTER_SHIFT;
+}
+
+void BackEMF_Reset(uint8_t motor) {
+    estimators[motor].prev_current = 0;
+    estimators[motor].speed_q8 = 0;
+}
+
+int32_t BackEMF_GetSpeed(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? (estimators[motor].speed_q8 >> 8) : 0;
+}
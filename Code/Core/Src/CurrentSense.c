@@ -0,0 +1,235 @@
+/*
+ * CurrentSense.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "CurrentSense.h"
+#include "PWM.h"
+#include "Timing.h"
+#include "main.h"
+
+#define ADC_FULL_SCALE          4096U
+#define ADC_SAMPLETIME_13CYCLES 0x2U    // SMPx = 010: 13.5 cycles
+#define CALIBRATION_TICKS       64U     // so tick lay trung binh offset zero
+
+// Double buffer: nua dau / nua sau moi nua chua N lan scan x MOTOR_COUNT kenh
+static volatile uint16_t adc_dma_buffer[2U * CONFIG_CURRENT_OVERSAMPLE_MAX * MOTOR_COUNT];
+
+static uint32_t decimation = 1;         // N: so chu ky PWM cong lai moi tick
+static uint32_t loop_hz;
+static int32_t  scale_q16;              // mA / (LSB tong N mau), Q16
+static uint32_t average_q16;            // 1 / N, Q16
+static uint32_t offset_raw[MOTOR_COUNT];
+static uint32_t offset_sum[MOTOR_COUNT];// offset_raw * N
+
+static uint32_t calib_ticks;
+static uint32_t calib_acc[MOTOR_COUNT];
+static uint32_t calib_samples;
+static volatile bool calibrated;
+
+static volatile uint32_t sample_seq;    // seqlock: le = dang ghi
+static CurrentSense_Sample_t sample;
+
+static void CurrentSense_SetSampleTime(uint32_t channel) {
+    if (channel <= 9U) {
+        MODIFY_REG(ADC1->SMPR2, 0x7U << (3U * channel), ADC_SAMPLETIME_13CYCLES << (3U * channel));
+    } else {
+        channel -= 10U;
+        MODIFY_REG(ADC1->SMPR1, 0x7U << (3U * channel), ADC_SAMPLETIME_13CYCLES << (3U * channel));
+    }
+}
+
+// ADC1_IN0..7 = PA0..PA7, IN8..9 = PB0..PB1. Chan thuoc ADC trong Driver.ioc nhung
+// HAL_ADC_Init khong duoc goi (thanh ghi ADC cau hinh o day) nen tu dat analog
+static void CurrentSense_InitPin(uint32_t channel) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
+    if (channel <= 7U) {
+        __HAL_RCC_GPIOA_CLK_ENABLE();
+        GPIO_InitStruct.Pin = (uint16_t)(1U << channel);
+        HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+    } else if (channel <= 9U) {
+        __HAL_RCC_GPIOB_CLK_ENABLE();
+        GPIO_InitStruct.Pin = (uint16_t)(1U << (channel - 8U));
+        HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+    }
+}
+
+static void CurrentSense_ComputeScaling(void) {
+    decimation = Timing_GetLoopDivider(PWM_GetFrequency(), CONFIG_CURRENT_LOOP_HZ);
+    if (decimation > CONFIG_CURRENT_OVERSAMPLE_MAX) {
+        decimation = CONFIG_CURRENT_OVERSAMPLE_MAX;
+    }
+    loop_hz = PWM_GetFrequency() / decimation;
+
+    // mA per LSB = Vref / 4096 / (mV/A) * 1000, chia cho N vi cong N mau
+    uint32_t base_q16 = (uint32_t)((((uint64_t)CONFIG_ADC_VREF_MV * 1000U) << 16) /
+                                   (ADC_FULL_SCALE * CONFIG_ACS712_MV_PER_A));
+    scale_q16 = (int32_t)(base_q16 / decimation);
+    average_q16 = 0x10000U / decimation;
+
+    for (uint8_t ch = 0; ch < MOTOR_COUNT; ch++) {
+        offset_sum[ch] = offset_raw[ch] * decimation;
+    }
+}
+
+static void CurrentSense_StartDma(void) {
+    DMA1_Channel1->CCR = 0;
+    DMA1->IFCR = DMA_IFCR_CGIF1;
+    DMA1_Channel1->CPAR = (uint32_t)&ADC1->DR;
+    DMA1_Channel1->CMAR = (uint32_t)adc_dma_buffer;
+    DMA1_Channel1->CNDTR = 2U * decimation * MOTOR_COUNT;
+    DMA1_Channel1->CCR = DMA_CCR_PL_1 | DMA_CCR_MSIZE_0 | DMA_CCR_PSIZE_0 |
+                         DMA_CCR_MINC | DMA_CCR_CIRC | DMA_CCR_HTIE | DMA_CCR_TCIE |
+                         DMA_CCR_EN;
+}
+
+void CurrentSense_Init(void) {
+    __HAL_RCC_ADC_CONFIG(RCC_ADCPCLK2_DIV6);   // ADC clock <= 14 MHz
+    __HAL_RCC_ADC1_CLK_ENABLE();
+    __HAL_RCC_DMA1_CLK_ENABLE();
+
+    CurrentSense_ComputeScaling();
+    CurrentSense_InitPin(CONFIG_CURRENT_M1_ADC_CHANNEL);
+    CurrentSense_InitPin(CONFIG_CURRENT_M2_ADC_CHANNEL);
+
+    // Scan M1, M2; trigger ngoai TIM1_CC2, ket qua qua DMA
+    ADC1->CR1 = ADC_CR1_SCAN;
+    ADC1->CR2 = ADC_CR2_EXTSEL_0 | ADC_CR2_DMA;
+    CurrentSense_SetSampleTime(CONFIG_CURRENT_M1_ADC_CHANNEL);
+    CurrentSense_SetSampleTime(CONFIG_CURRENT_M2_ADC_CHANNEL);
+    ADC1->SQR1 = (MOTOR_COUNT - 1U) << ADC_SQR1_L_Pos;
+    ADC1->SQR3 = (CONFIG_CURRENT_M1_ADC_CHANNEL << ADC_SQR3_SQ1_Pos) |
+                 (CONFIG_CURRENT_M2_ADC_CHANNEL << ADC_SQR3_SQ2_Pos);
+
+    ADC1->CR2 |= ADC_CR2_ADON;
+    HAL_Delay(1);                               // tSTAB
+    ADC1->CR2 |= ADC_CR2_RSTCAL;
+    while (ADC1->CR2 & ADC_CR2_RSTCAL) {}
+    ADC1->CR2 |= ADC_CR2_CAL;
+    while (ADC1->CR2 & ADC_CR2_CAL) {}
+
+    CurrentSense_StartDma();
+    HAL_NVIC_SetPriority(DMA1_Channel1_IRQn, 2, 0);
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+
+    ADC1->CR2 |= ADC_CR2_EXTTRIG;
+}
+
+void CurrentSense_Reconfigure(void) {
+    // Dung ADC (ADON = 0 reset vi tri scan), doi do dai DMA roi chay lai
+    ADC1->CR2 &= ~(ADC_CR2_EXTTRIG | ADC_CR2_ADON);
+    HAL_NVIC_DisableIRQ(DMA1_Channel1_IRQn);
+
+    CurrentSense_ComputeScaling();
+    CurrentSense_StartDma();
+
+    HAL_NVIC_EnableIRQ(DMA1_Channel1_IRQn);
+    ADC1->CR2 |= ADC_CR2_ADON;
+    for (volatile uint32_t i = 0; i < 100U; i++) {}  // tSTAB ~1 us
+    ADC1->CR2 |= ADC_CR2_EXTTRIG;
+}
+
+static void CurrentSense_Process(const volatile uint16_t *scan) {
+    uint32_t sum[MOTOR_COUNT] = {0};
+    for (uint32_t n = 0; n < decimation; n++) {
+        for (uint8_t ch = 0; ch < MOTOR_COUNT; ch++) {
+            sum[ch] += scan[ch];
+        }
+        scan += MOTOR_COUNT;
+    }
+
+    if (!calibrated) {
+        for (uint8_t ch = 0; ch < MOTOR_COUNT; ch++) {
+            calib_acc[ch] += sum[ch];
+        }
+        calib_samples += decimation;
+        if (++calib_ticks >= CALIBRATION_TICKS) {
+            for (uint8_t ch = 0; ch < MOTOR_COUNT; ch++) {
+                offset_raw[ch] = (calib_acc[ch] + calib_samples / 2U) / calib_samples;
+                offset_sum[ch] = offset_raw[ch] * decimation;
+            }
+            calibrated = true;
+        }
+        return;
+    }
+
+    sample_seq++;
+    __DMB();
+    for (uint8_t ch = 0; ch < MOTOR_COUNT; ch++) {
+        int32_t ma = (int32_t)(((int64_t)((int32_t)sum[ch] - (int32_t)offset_sum[ch]) * scale_q16) >> 16);
+        if (ma > INT16_MAX) {
+            ma = INT16_MAX;
+        } else if (ma < INT16_MIN) {
+            ma = INT16_MIN;
+        }
+        sample.current_ma[ch] = (int16_t)ma;
+        sample.raw[ch] = (uint16_t)(((uint64_t)sum[ch] * average_q16) >> 16);
+    }
+    sample.tick++;
+    __DMB();
+    sample_seq++;
+
+    CurrentSense_SampleCallback();
+}
+
+void CurrentSense_IRQHandler(void) {
+    uint32_t isr = DMA1->ISR;
+    uint32_t half = decimation * MOTOR_COUNT;
+
+    if (isr & DMA_ISR_HTIF1) {
+        DMA1->IFCR = DMA_IFCR_CHTIF1;
+        CurrentSense_Process(&adc_dma_buffer[0]);
+    }
+    if (isr & DMA_ISR_TCIF1) {
+        DMA1->IFCR = DMA_IFCR_CTCIF1;
+        CurrentSense_Process(&adc_dma_buffer[half]);
+    }
+    if (isr & DMA_ISR_TEIF1) {
+        DMA1->IFCR = DMA_IFCR_CTEIF1;
+    }
+}
+
+int16_t CurrentSense_GetMilliAmps(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? sample.current_ma[motor] : 0;
+}
+
+void CurrentSense_GetSample(CurrentSense_Sample_t *out) {
+    uint32_t seq;
+    do {
+        seq = sample_seq;
+        __DMB();
+        *out = sample;
+        __DMB();
+    } while ((seq & 1U) || seq != sample_seq);
+}
+
+uint16_t CurrentSense_MilliAmpsToRaw(uint8_t motor, int32_t ma) {
+    if (motor >= MOTOR_COUNT) {
+        return 0;
+    }
+    // LSB = mA * 4096 * (mV/A) / (Vref_mV * 1000)
+    int32_t delta = (int32_t)(((int64_t)ma * ADC_FULL_SCALE * CONFIG_ACS712_MV_PER_A) /
+                              ((int32_t)CONFIG_ADC_VREF_MV * 1000));
+    int32_t raw = (int32_t)offset_raw[motor] + delta;
+    if (raw < 0) {
+        raw = 0;
+    } else if (raw > (int32_t)(ADC_FULL_SCALE - 1U)) {
+        raw = ADC_FULL_SCALE - 1U;
+    }
+    return (uint16_t)raw;
+}
+
+uint32_t CurrentSense_GetLoopHz(void) {
+    return loop_hz;
+}
+
+bool CurrentSense_IsReady(void) {
+    return calibrated;
+}
+
+__weak void CurrentSense_SampleCallback(void) {
+}
@@ -0,0 +1,193 @@
+/*
+ * DiffDrive.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "DiffDrive.h"
+#include "FixedPoint.h"
+#include "Ramp.h"
+#include "cmsis_os.h"
+
+#define DIFF_TWO_PI_Q16         411775LL        // 2*pi * 2^16
+#define DIFF_NM_PER_MM          1000000LL
+#define DIFF_NM_PER_RADIUS      10000LL         // wheel_radius la 0.01 mm
+#define DIFF_MRAD_PER_TURN      6283LL          // 2*pi * 1000
+
+/*
+ * Goc theta luu dang goc nhi phan (2^32 = 1 vong) de tu quay vong, sin/cos
+ * bang bang 1/4 chu ky 64 doan (Q15) noi suy tuyen tinh.
+ */
+static const int16_t sin_table[65] = {
+    0, 804, 1608, 2410, 3212, 4011, 4808, 5602,
+    6393, 7179, 7962, 8739, 9512, 10278, 11039, 11793,
+    12539, 13279, 14010, 14732, 15446, 16151, 16846, 17530,
+    18204, 18868, 19519, 20159, 20787, 21403, 22005, 22594,
+    23170, 23731, 24279, 24811, 25329, 25832, 26319, 26790,
+    27245, 27683, 28105, 28510, 28898, 29268, 29621, 29956,
+    30273, 30571, 30852, 31113, 31356, 31580, 31785, 31971,
+    32137, 32285, 32412, 32521, 32609, 32678, 32728, 32757,
+    32767,
+};
+
+typedef struct {
+    uint32_t tick;
+    bool     has_tick;
+    Ramp_t   v_ramp;            // mm/s
+    Ramp_t   w_ramp;            // mrad/s
+    int32_t  wheel_rpm[2];
+    bool     saturated;
+
+    int64_t  x_nm;
+    int64_t  y_nm;
+    uint32_t theta;             // goc nhi phan
+    int32_t  last_position[2];
+    bool     has_position[2];
+    int16_t  v_mm_s;
+    int16_t  w_mrad_s;
+} DiffDrive_t;
+
+static DiffDrive_t diff;
+
+static int32_t DiffDrive_Sin(uint32_t angle) {
+    uint32_t quarter = angle >> 30;
+    uint32_t a = angle & 0x3FFFFFFFUL;
+    uint32_t idx, frac;
+    int32_t s;
+
+    if (quarter & 1U) {
+        a = 0x40000000UL - a;
+    }
+    idx = a >> 24;
+    frac = (a >> 8) & 0xFFFFU;
+    s = sin_table[idx];
+    if (idx < 64U) {
+        s += ((sin_table[idx + 1U] - sin_table[idx]) * (int32_t)frac) >> 16;
+    }
+    return (quarter & 2U) ? -s : s;
+}
+
+static int32_t DiffDrive_Cos(uint32_t angle) {
+    return DiffDrive_Sin(angle + 0x40000000UL);
+}
+
+// Chu vi banh (nm)
+static int64_t DiffDrive_WheelCircumference(const DiffDrive_Params_t *params) {
+    return ((int64_t)params->wheel_radius * DIFF_NM_PER_RADIUS * DIFF_TWO_PI_Q16) >> 16;
+}
+
+static void DiffDrive_Command(const DiffDrive_Params_t *params, int32_t v_mm_s, int32_t w_mrad_s,
+                              uint32_t loop_hz) {
+    int64_t circ_nm = DiffDrive_WheelCircumference(params);
+    int64_t limit = (params->max_wheel_rpm != 0U) ? params->max_wheel_rpm : INT16_MAX;
+    int32_t v = Ramp_Update(&diff.v_ramp, v_mm_s, params->accel, params->accel, loop_hz);
+    int32_t w = Ramp_Update(&diff.w_ramp, w_mrad_s, params->alpha, params->alpha, loop_hz);
+    int64_t half_um_s = ((int64_t)w * params->wheel_base_mm) / 2;     // mrad/s * mm = um/s
+    int64_t rpm[2], peak;
+
+    diff.saturated = false;
+    if (circ_nm == 0) {
+        diff.wheel_rpm[0] = 0;
+        diff.wheel_rpm[1] = 0;
+        return;
+    }
+
+    // Banh (um/s) -> RPM = um/s * 60 * 1000 / chu vi (nm)
+    rpm[0] = (((int64_t)v * 1000 - half_um_s) * 60000) / circ_nm;
+    rpm[1] = (((int64_t)v * 1000 + half_um_s) * 60000) / circ_nm;
+
+    // Chia ca hai banh cung ti le: ti so trai/phai (do cong) khong doi
+    peak = (rpm[0] < 0) ? -rpm[0] : rpm[0];
+    if (rpm[1] > peak || -rpm[1] > peak) {
+        peak = (rpm[1] < 0) ? -rpm[1] : rpm[1];
+    }
+    if (peak > limit) {
+        rpm[0] = (rpm[0] * limit) / peak;
+        rpm[1] = (rpm[1] * limit) / peak;
+        diff.saturated = true;
+    }
+    diff.wheel_rpm[0] = (int32_t)rpm[0];
+    diff.wheel_rpm[1] = (int32_t)rpm[1];
+}
+
+static void DiffDrive_Integrate(const DiffDrive_Params_t *params, const DiffDrive_Wheel_t wheels[2],
+                                uint32_t loop_hz) {
+    int64_t circ_nm = DiffDrive_WheelCircumference(params);
+    int64_t base_nm = ((int64_t)params->wheel_base_mm * DIFF_NM_PER_MM * DIFF_TWO_PI_Q16) >> 16;
+    int64_t d[2], dist, dtheta = 0;
+    uint32_t mid;
+
+    // Quang duong moi banh trong tick: encoder neu co, nguoc lai theo toc do do
+    for (uint8_t i = 0; i < 2U; i++) {
+        if (wheels[i].counts_per_rev != 0U && diff.has_position[i]) {
+            int32_t delta = (int32_t)((uint32_t)wheels[i].position - (uint32_t)diff.last_position[i]);
+            d[i] = ((int64_t)delta * circ_nm) / wheels[i].counts_per_rev;
+        } else {
+            d[i] = ((int64_t)wheels[i].rpm * circ_nm) / (60LL * loop_hz);
+        }
+        diff.last_position[i] = wheels[i].position;
+        diff.has_position[i] = (wheels[i].counts_per_rev != 0U);
+    }
+
+    dist = (d[0] + d[1]) / 2;
+    if (base_nm != 0) {
+        // dtheta [vong] = (d_phai - d_trai) / (2*pi*b), theo goc nhi phan 2^32
+        int64_t diff_nm = FP_Saturate(d[1] - d[0], -(1L << 30), 1L << 30);
+        dtheta = (diff_nm * (1LL << 32)) / base_nm;
+    }
+
+    // Tich phan theo goc giua tick (bac 2)
+    mid = diff.theta + (uint32_t)(dtheta / 2);
+    diff.x_nm += (dist * DiffDrive_Cos(mid)) >> 15;
+    diff.y_nm += (dist * DiffDrive_Sin(mid)) >> 15;
+    diff.theta += (uint32_t)dtheta;
+
+    diff.v_mm_s = FP_Sat16(FP_Sat32((dist * loop_hz) / DIFF_NM_PER_MM));
+    diff.w_mrad_s = FP_Sat16(FP_Sat32((dtheta * DIFF_MRAD_PER_TURN * loop_hz) >> 32));
+}
+
+void DiffDrive_Update(uint32_t tick, const DiffDrive_Params_t *params, int32_t v_mm_s,
+                      int32_t w_mrad_s, const DiffDrive_Wheel_t wheels[2], uint32_t loop_hz) {
+    int32_t lock = osKernelLock();
+
+    // Task motor kia da tinh tick nay: dung chung ket qua
+    if (!diff.has_tick || diff.tick != tick) {
+        diff.tick = tick;
+        diff.has_tick = true;
+        DiffDrive_Command(params, v_mm_s, w_mrad_s, loop_hz);
+        DiffDrive_Integrate(params, wheels, loop_hz);
+    }
+    osKernelRestoreLock(lock);
+}
+
+int32_t DiffDrive_GetWheelRpm(uint8_t wheel) {
+    return diff.wheel_rpm[wheel];
+}
+
+bool DiffDrive_IsSaturated(void) {
+    return diff.saturated;
+}
+
+void DiffDrive_ResetCommand(void) {
+    Ramp_Reset(&diff.v_ramp, 0);
+    Ramp_Reset(&diff.w_ramp, 0);
+    diff.wheel_rpm[0] = 0;
+    diff.wheel_rpm[1] = 0;
+}
+
+void DiffDrive_ResetOdometry(void) {
+    int32_t lock = osKernelLock();
+    diff.x_nm = 0;
+    diff.y_nm = 0;
+    diff.theta = 0;
+    osKernelRestoreLock(lock);
+}
+
+void DiffDrive_GetOdometry(DiffDrive_Odometry_t *out) {
+    out->x_mm = FP_Sat32(diff.x_nm / DIFF_NM_PER_MM);
+    out->y_mm = FP_Sat32(diff.y_nm / DIFF_NM_PER_MM);
+    out->theta_mrad = (int16_t)(((int64_t)(int32_t)diff.theta * DIFF_MRAD_PER_TURN) >> 32);
+    out->v_mm_s = diff.v_mm_s;
+    out->w_mrad_s = diff.w_mrad_s;
+}
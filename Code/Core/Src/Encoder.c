@@ -0,0 +1,190 @@
+/*
+ * Encoder.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Encoder.h"
+#include "main.h"
+#include "Config.h"
+#include "Timing.h"
+
+#define ENCODER_IRQ_PRIORITY    1U      // sau OCP (0), truoc DMA dong dien (2)
+
+typedef struct {
+    GPIO_TypeDef *a_port;
+    uint16_t      a_pin;
+    GPIO_TypeDef *b_port;
+    uint16_t      b_pin;
+} Encoder_Pins_t;
+
+typedef struct {
+    /* Ghi trong ISR */
+    volatile int32_t  count;
+    volatile uint32_t edge_cycles;
+    uint8_t state;                      // (A << 1) | B
+
+    /* Chi dung trong task */
+    bool     enabled;
+    uint32_t counts_per_rev;            // 4 * ppr
+    int32_t  prev_count;
+    uint32_t prev_edge_cycles;
+    Encoder_Sample_t sample;
+} Encoder_t;
+
+static const Encoder_Pins_t encoder_pins[MOTOR_COUNT] = {
+    { IN1_GPIO_Port, IN1_Pin, IN2_GPIO_Port, IN2_Pin },
+    { IN3_GPIO_Port, IN3_Pin, IN4_GPIO_Port, IN4_Pin },
+};
+
+static Encoder_t encoders[MOTOR_COUNT];
+
+// Giai ma x4: index = (state cu << 2) | state moi
+static const int8_t quadrature_table[16] = {
+     0, +1, -1,  0,
+    -1,  0,  0, +1,
+    +1,  0,  0, -1,
+     0, -1, +1,  0,
+};
+
+static uint8_t Encoder_ReadState(const Encoder_Pins_t *pins) {
+    uint8_t a = (pins->a_port->IDR & pins->a_pin) ? 1U : 0U;
+    uint8_t b = (pins->b_port->IDR & pins->b_pin) ? 1U : 0U;
+    return (uint8_t)((a << 1) | b);
+}
+
+void Encoder_Init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    // MX_GPIO_Init (Driver.ioc) mo san cac line EXTI: khoa lai den khi
+    // Encoder_Configure() bat encoder (ppr != 0)
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        uint32_t mask = encoder_pins[i].a_pin | encoder_pins[i].b_pin;
+        EXTI->IMR &= ~mask;
+        EXTI->PR = mask;
+    }
+
+    HAL_NVIC_SetPriority(EXTI9_5_IRQn, ENCODER_IRQ_PRIORITY, 0);
+    HAL_NVIC_SetPriority(EXTI15_10_IRQn, ENCODER_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(EXTI9_5_IRQn);
+    HAL_NVIC_EnableIRQ(EXTI15_10_IRQn);
+}
+
+void Encoder_Configure(uint8_t motor, uint16_t ppr) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    const Encoder_Pins_t *pins = &encoder_pins[motor];
+    Encoder_t *enc = &encoders[motor];
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+    GPIO_InitStruct.Mode = (ppr != 0U) ? GPIO_MODE_IT_RISING_FALLING : GPIO_MODE_INPUT;
+    GPIO_InitStruct.Pull = GPIO_NOPULL;
+
+    // Tat ngat truoc khi doi trang thai dem
+    EXTI->IMR &= ~(uint32_t)(pins->a_pin | pins->b_pin);
+
+    enc->enabled = (ppr != 0U);
+    enc->counts_per_rev = 4U * ppr;
+    enc->state = Encoder_ReadState(pins);
+    enc->count = 0;
+    enc->edge_cycles = DWT->CYCCNT;
+    enc->prev_count = 0;
+    enc->prev_edge_cycles = enc->edge_cycles;
+    enc->sample.speed_rpm = 0;
+    enc->sample.count = 0;
+
+    GPIO_InitStruct.Pin = pins->a_pin;
+    HAL_GPIO_Init(pins->a_port, &GPIO_InitStruct);
+    GPIO_InitStruct.Pin = pins->b_pin;
+    HAL_GPIO_Init(pins->b_port, &GPIO_InitStruct);
+    __HAL_GPIO_EXTI_CLEAR_IT(pins->a_pin | pins->b_pin);
+}
+
+bool Encoder_IsEnabled(uint8_t motor) {
+    return (motor < MOTOR_COUNT) && encoders[motor].enabled;
+}
+
+void Encoder_Update(uint8_t motor) {
+    if (!Encoder_IsEnabled(motor)) {
+        return;
+    }
+    Encoder_t *enc = &encoders[motor];
+    uint32_t clk = Timing_GetSysClockHz();
+    int32_t count;
+    uint32_t edge_cycles, now;
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    count = enc->count;
+    edge_cycles = enc->edge_cycles;
+    now = DWT->CYCCNT;
+    __set_PRIMASK(primask);
+
+    int32_t delta = count - enc->prev_count;
+    int64_t rpm;
+
+    if (delta != 0) {
+        // M/T: delta canh trong (edge_cycles - prev_edge_cycles) chu ky CPU
+        uint32_t dt = edge_cycles - enc->prev_edge_cycles;
+        if (dt == 0U) {
+            dt = 1U;
+        }
+        rpm = ((int64_t)delta * 60 * clk) / ((int64_t)enc->counts_per_rev * dt);
+        enc->prev_count = count;
+        enc->prev_edge_cycles = edge_cycles;
+    } else {
+        uint32_t since = now - enc->prev_edge_cycles;
+        if (since >= (clk / 1000U) * CONFIG_ENCODER_TIMEOUT_MS) {
+            rpm = 0;
+            enc->prev_edge_cycles = now - (clk / 1000U) * CONFIG_ENCODER_TIMEOUT_MS;  // tranh tran CYCCNT
+        } else {
+            // Chua co canh moi: toc do thuc khong the lon hon 1 canh / since
+            int64_t bound = (60LL * clk) / ((int64_t)enc->counts_per_rev * since);
+            rpm = enc->sample.speed_rpm;
+            if (rpm > bound) {
+                rpm = bound;
+            } else if (rpm < -bound) {
+                rpm = -bound;
+            }
+        }
+    }
+
+    enc->sample.speed_rpm = (int32_t)rpm;
+    enc->sample.count = count;
+    enc->sample.timestamp_ms = HAL_GetTick();
+    enc->sample.edge_cycles = enc->prev_edge_cycles;
+}
+
+void Encoder_GetSample(uint8_t motor, Encoder_Sample_t *out) {
+    if (motor < MOTOR_COUNT) {
+        *out = encoders[motor].sample;
+    }
+}
+
+void Encoder_IRQHandler(void) {
+    uint32_t now = DWT->CYCCNT;
+    uint32_t pending = EXTI->PR;
+
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        const Encoder_Pins_t *pins = &encoder_pins[i];
+        uint32_t mask = pins->a_pin | pins->b_pin;
+
+        if ((pending & mask) == 0U) {
+            continue;
+        }
+        EXTI->PR = pending & mask;
+
+        Encoder_t *enc = &encoders[i];
+        uint8_t state = Encoder_ReadState(pins);
+        int8_t step = quadrature_table[(enc->state << 2) | state];
+        enc->state = state;
+        if (step != 0) {
+            enc->count += step;
+            enc->edge_cycles = now;
+        }
+    }
+}
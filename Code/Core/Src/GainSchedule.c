@@ -0,0 +1,83 @@
+/*
+ * GainSchedule.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "GainSchedule.h"
+
+void GainSchedule_SetPoint(GainSchedule_t *sched, uint8_t index, int32_t x, const PID_Gains_t *gains) {
+    GainSchedule_Disable(sched);
+    if (index < GAIN_SCHED_MAX_POINTS) {
+        sched->x[index] = x;
+        sched->gains[index] = *gains;
+    }
+}
+
+bool GainSchedule_Commit(GainSchedule_t *sched, uint8_t count) {
+    GainSchedule_Disable(sched);
+    if (count < 2U || count > GAIN_SCHED_MAX_POINTS) {
+        return false;
+    }
+    for (uint8_t i = 1; i < count; i++) {
+        if (sched->x[i] <= sched->x[i - 1]) {
+            return false;
+        }
+    }
+
+    for (uint8_t i = 1; i < count; i++) {
+        sched->inv_dx_q24[i - 1] = (uint32_t)((1UL << 24) / (uint32_t)(sched->x[i] - sched->x[i - 1]));
+    }
+    sched->count = count;
+    return true;
+}
+
+void GainSchedule_Disable(GainSchedule_t *sched) {
+    sched->count = 0;
+    sched->segment = 0;
+}
+
+bool GainSchedule_IsEnabled(const GainSchedule_t *sched) {
+    return sched->count != 0U;
+}
+
+static int32_t GainSchedule_Lerp(int32_t a, int32_t b, int32_t frac_q16) {
+    return a + (int32_t)((((int64_t)b - a) * frac_q16) >> 16);
+}
+
+uint8_t GainSchedule_Evaluate(GainSchedule_t *sched, int32_t x, PID_Gains_t *out) {
+    uint8_t seg = sched->segment;
+    uint8_t last = (uint8_t)(sched->count - 1U);
+    const PID_Gains_t *g0, *g1;
+    int32_t frac_q16;
+
+    // x thay doi cham giua 2 chu ky: di tiep tu doan cu thay vi tim lai tu dau
+    while (seg > 0U && x < sched->x[seg]) {
+        seg--;
+    }
+    while (seg < last - 1U && x >= sched->x[seg + 1U]) {
+        seg++;
+    }
+    sched->segment = seg;
+
+    if (x <= sched->x[0]) {
+        *out = sched->gains[0];
+        return seg;
+    }
+    if (x >= sched->x[last]) {
+        *out = sched->gains[last];
+        return seg;
+    }
+
+    frac_q16 = (int32_t)(((uint64_t)(uint32_t)(x - sched->x[seg]) * sched->inv_dx_q24[seg]) >> 8);
+    if (frac_q16 > (1L << 16)) {
+        frac_q16 = 1L << 16;
+    }
+    g0 = &sched->gains[seg];
+    g1 = &sched->gains[seg + 1U];
+    out->kp = GainSchedule_Lerp(g0->kp, g1->kp, frac_q16);
+    out->ki = GainSchedule_Lerp(g0->ki, g1->ki, frac_q16);
+    out->kd = GainSchedule_Lerp(g0->kd, g1->kd, frac_q16);
+    return seg;
+}
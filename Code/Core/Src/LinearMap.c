@@ -0,0 +1,80 @@
+/*
+ * LinearMap.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "LinearMap.h"
+#include "Config.h"
+#include "PWM.h"
+
+#define LINEAR_INPUT_SHIFT      10U     // input 0-1000 -> 0-1024 (Q10)
+#define LINEAR_SEGMENT_SHIFT    (LINEAR_INPUT_SHIFT - 4U)   // 16 doan deu
+
+_Static_assert((1U << (LINEAR_INPUT_SHIFT - LINEAR_SEGMENT_SHIFT)) == LINEAR_LUT_SEGMENTS,
+               "LINEAR_LUT_SEGMENTS must match the segment shift");
+
+typedef struct {
+    bool enabled;
+    int16_t duty[LINEAR_LUT_POINTS];    // Q15, da cong vung chet
+} LinearMap_t;
+
+static LinearMap_t maps[MOTOR_COUNT];
+
+bool LinearMap_Configure(uint8_t motor, const uint16_t *points, uint16_t deadband) {
+    if (motor >= MOTOR_COUNT) {
+        return false;
+    }
+    LinearMap_t *map = &maps[motor];
+    uint32_t dead, span;
+
+    map->enabled = false;
+    if (deadband > 1000U) {
+        return false;
+    }
+    for (uint8_t i = 0; i < LINEAR_LUT_POINTS; i++) {
+        if (points[i] > 1000U || (i > 0U && points[i] < points[i - 1U])) {
+            return false;
+        }
+    }
+
+    dead = ((uint32_t)deadband * PWM_DUTY_MAX) / 1000U;
+    span = PWM_DUTY_MAX - dead;
+    for (uint8_t i = 0; i < LINEAR_LUT_POINTS; i++) {
+        map->duty[i] = (int16_t)(dead + ((uint32_t)points[i] * span) / 1000U);
+    }
+    map->enabled = true;
+    return true;
+}
+
+void LinearMap_Disable(uint8_t motor) {
+    if (motor < MOTOR_COUNT) {
+        maps[motor].enabled = false;
+    }
+}
+
+bool LinearMap_IsEnabled(uint8_t motor) {
+    return motor < MOTOR_COUNT && maps[motor].enabled;
+}
+
+int16_t LinearMap_Lookup(uint8_t motor, uint16_t input) {
+    const int16_t *duty = maps[motor].duty;
+    uint32_t u, seg, frac;
+
+    if (input == 0U) {
+        return 0;
+    }
+    if (input > 1000U) {
+        input = 1000U;
+    }
+
+    // 1024 / 1000 = 67109 / 2^16: khong chia trong vong lap
+    u = ((uint32_t)input * 67109U) >> 16;
+    seg = u >> LINEAR_SEGMENT_SHIFT;
+    if (seg >= LINEAR_LUT_SEGMENTS) {
+        return duty[LINEAR_LUT_SEGMENTS];
+    }
+    frac = u & ((1U << LINEAR_SEGMENT_SHIFT) - 1U);
+    return (int16_t)(duty[seg] + (((int32_t)(duty[seg + 1U] - duty[seg]) * (int32_t)frac) >> LINEAR_SEGMENT_SHIFT));
+}
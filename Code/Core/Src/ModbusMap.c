@@ -1,51 +1,269 @@
 #include "ModbusMap.h"
+#include <stddef.h>
 
+// Register address == word offset inside tModbusRegisters
+_Static_assert(sizeof(tModbusRegisters) == TOTAL_REG_COUNT * sizeof(uint16_t),
+               "tModbusRegisters layout does not match TOTAL_REG_COUNT");
+_Static_assert(offsetof(tModbusRegisters, m2) == REG_M2_CONTROL_MODE * sizeof(uint16_t),
+               "Motor 2 block misaligned");
+_Static_assert(offsetof(tModbusRegisters, device_id) == REG_DEVICE_ID * sizeof(uint16_t),
+               "System block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_ctrl) == REG_M1_CURRENT_KP * sizeof(uint16_t),
+               "Motor 1 control block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_ctrl) == REG_M2_CURRENT_KP * sizeof(uint16_t),
+               "Motor 2 control block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_sched) == REG_M1_SCHED_SOURCE * sizeof(uint16_t),
+               "Motor 1 gain schedule misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_sched) == REG_M2_SCHED_SOURCE * sizeof(uint16_t),
+               "Motor 2 gain schedule misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_motion) == REG_M1_TARGET_POS_HI * sizeof(uint16_t),
+               "Motor 1 motion block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_motion) == REG_M2_TARGET_POS_HI * sizeof(uint16_t),
+               "Motor 2 motion block misaligned");
+_Static_assert(offsetof(tModbusRegisters, coupling) == REG_GEAR_SOURCE * sizeof(uint16_t),
+               "Coupling block misaligned");
+_Static_assert(offsetof(tModbusRegisters, drive) == REG_DRIVE_V_CMD * sizeof(uint16_t),
+               "Drive block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_thermal) == REG_M1_THERMAL_RATED * sizeof(uint16_t),
+               "Motor 1 thermal block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_thermal) == REG_M2_THERMAL_RATED * sizeof(uint16_t),
+               "Motor 2 thermal block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_stall) == REG_M1_STALL_REACTION * sizeof(uint16_t),
+               "Motor 1 stall block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_stall) == REG_M2_STALL_REACTION * sizeof(uint16_t),
+               "Motor 2 stall block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_linear) == REG_M1_LIN_ENABLE * sizeof(uint16_t),
+               "Motor 1 linear table block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_linear) == REG_M2_LIN_ENABLE * sizeof(uint16_t),
+               "Motor 2 linear table block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m1_onoff) == REG_M1_ONOFF_SOURCE * sizeof(uint16_t),
+               "Motor 1 ON/OFF block misaligned");
+_Static_assert(offsetof(tModbusRegisters, m2_onoff) == REG_M2_ONOFF_SOURCE * sizeof(uint16_t),
+               "Motor 2 ON/OFF block misaligned");
+_Static_assert(offsetof(tModbusRegisters, proximity) == REG_PROX_SOURCE * sizeof(uint16_t),
+               "Proximity block misaligned");
+_Static_assert(offsetof(tModbusRegisters, pwm_post) == REG_PWM_MIN_PULSE * sizeof(uint16_t),
+               "PWM post-processing block misaligned");
+_Static_assert(offsetof(tModbusRegisters, msm.log) == REG_MSM_LOG * sizeof(uint16_t),
+               "State machine block misaligned");
+_Static_assert(offsetof(tLinearRegisters, table) == (REG_M1_LIN_TABLE - REG_M1_LIN_ENABLE) * sizeof(uint16_t),
+               "Linear table misaligned");
+_Static_assert(sizeof(tLinearRegisters) == 32U * sizeof(uint16_t),
+               "Linear table block must stay 32 registers");
+_Static_assert(offsetof(tMotionRegisters, staging) == (REG_M1_QUEUE_STAGING - REG_M1_TARGET_POS_HI) * sizeof(uint16_t),
+               "Motion queue staging misaligned");
+_Static_assert(sizeof(tMotionRegisters) == 32U * sizeof(uint16_t),
+               "Motion block must stay 32 registers");
+_Static_assert(offsetof(tGainScheduleRegisters, points) == (REG_M1_SCHED_TABLE - REG_M1_SCHED_SOURCE) * sizeof(uint16_t),
+               "Gain schedule table misaligned");
+
+// Bang tuyen tinh mac dinh: duty = input (giong khi tat bang)
+#define LINEAR_LUT_IDENTITY { 0, 63, 125, 188, 250, 313, 375, 438, 500, \
+                              563, 625, 688, 750, 813, 875, 938, 1000 }
 
 // Global instance of register map
 tModbusRegisters g_modbus_data = {
-    // Motor 1 (0x0000 - 0x000D)
-    .m1_mode = 1,
-    .m1_onoff_en = 0,
-    .m1_linear_en = 0,
-    .m1_pid_en = 0,
-    .m1_cmd_speed = 0,
-    .m1_linear_input = 0,
-    .m1_actual_speed = 0,
-    .m1_direction = 0,
-    .m1_kp = 100,
-    .m1_ki = 10,
-    .m1_kd = 5,
-    .m1_status = 0,
-    .m1_error = 0,
-
-    // Motor 2 (0x0010 - 0x001D)
-    .m2_mode = 1,
-    .m2_onoff_en = 0,
-    .m2_linear_en = 0,
-    .m2_pid_en = 0,
-    .m2_cmd_speed = 0,
-    .m2_linear_input = 0,
-    .m2_actual_speed = 0,
-    .m2_direction = 0,
-    .m2_kp = 100,
-    .m2_ki = 10,
-    .m2_kd = 5,
-    .m2_status = 0,
-    .m2_error = 0,
-
-    // System (0x0020 - 0x0026)
+    // Motor 1 (0x0000 - 0x000F)
+    .m1 = {
+        .mode = 1,
+        .onoff_en = 0,
+        .linear_en = 0,
+        .pid_en = 0,
+        .cmd_speed = 0,
+        .linear_input = 0,
+        .actual_speed = 0,
+        .direction = 0,
+        .kp = 100,
+        .ki = 10,
+        .kd = 5,
+        .status = 0,
+        .error = 0,
+    },
+
+    // Motor 2 (0x0010 - 0x001F)
+    .m2 = {
+        .mode = 1,
+        .onoff_en = 0,
+        .linear_en = 0,
+        .pid_en = 0,
+        .cmd_speed = 0,
+        .linear_input = 0,
+        .actual_speed = 0,
+        .direction = 0,
+        .kp = 100,
+        .ki = 10,
+        .kd = 5,
+        .status = 0,
+        .error = 0,
+    },
+
+    // System (0x0020 - 0x002F)
     .device_id = 1,
     .firmware_ver = 0x0101,
     .system_status = 0,
     .system_error = 0,
     .reset_error_cmd = 0,
     .config_baudrate = 2,
-    .config_parity = 0
+    .config_parity = 0,
+    .sysclk_mhz = 0,
+    .pwm_freq_khz = 20,
+    .pwm_align = 0,
+    .pwm_resolution = 0,
+    .ocp_threshold_ma = 5000,
+    .vbus_mv = 12000,
+    .pwm_output = PWM_OUTPUT_SINGLE,
+    .pwm_dead_time_ns = 500,
+
+    // Motor 1 control (0x0030 - 0x004F)
+    .m1_ctrl = {
+        .cur_kp = 150,
+        .cur_ki = 150,
+        .current_limit_ma = 3000,
+        .encoder_ppr = 0,
+        .motor_r_mohm = 0,
+        .motor_l_uh = 0,
+        .motor_ke = 0,
+        .tune_amplitude = 200,
+        .tune_hysteresis = 10,
+        .ident_duty = 300,
+        .stop_mode = STOP_MODE_COAST,
+        .regen_limit_ma = 500,
+        .brake_duty = 1000,
+    },
+
+    // Motor 2 control (0x0050 - 0x006F)
+    .m2_ctrl = {
+        .cur_kp = 150,
+        .cur_ki = 150,
+        .current_limit_ma = 3000,
+        .encoder_ppr = 0,
+        .motor_r_mohm = 0,
+        .motor_l_uh = 0,
+        .motor_ke = 0,
+        .tune_amplitude = 200,
+        .tune_hysteresis = 10,
+        .ident_duty = 300,
+        .stop_mode = STOP_MODE_COAST,
+        .regen_limit_ma = 500,
+        .brake_duty = 1000,
+    },
+
+    // Gain schedules (0x0070 - 0x00AF), off until the master loads a table
+    .m1_sched = {
+        .active = GAIN_SCHED_ACTIVE_NONE,
+    },
+    .m2_sched = {
+        .active = GAIN_SCHED_ACTIVE_NONE,
+    },
+
+    // Motion (0x00B0 - 0x00EF)
+    .m1_motion = {
+        .move_vmax = 1000,
+        .move_accel = 2000,
+        .pos_kp = 1000,
+        .in_pos_window = 10,
+    },
+    .m2_motion = {
+        .move_vmax = 1000,
+        .move_accel = 2000,
+        .pos_kp = 1000,
+        .in_pos_window = 10,
+    },
+
+    // Coupling (0x00F0 - 0x00FF)
+    .coupling = {
+        .source = GEAR_SOURCE_SPEED,
+        .numerator = 1,
+        .denominator = 1,
+    },
+
+    // Differential drive (0x0100 - 0x011F)
+    .drive = {
+        .wheel_base_mm = 300,
+        .wheel_radius = 5000,
+    },
+
+    // Thermal model (0x0120 - 0x013F)
+    .m1_thermal = {
+        .motor_rated_ma = 3000,
+        .motor_tau_s = 60,
+        .horizon_ms = 1000,
+    },
+    .m2_thermal = {
+        .motor_rated_ma = 3000,
+        .motor_tau_s = 60,
+        .horizon_ms = 1000,
+    },
+
+    // Stall detection (0x0140 - 0x015F)
+    .m1_stall = {
+        .reaction = STALL_REACTION_OFF,
+        .current_ma = 2500,
+        .speed_rpm = 10,
+        .duty_pm = 300,
+        .time_ms = 100,
+        .reduce_pct = 30,
+        .retry_delay_ms = 500,
+        .retry_max = 3,
+    },
+    .m2_stall = {
+        .reaction = STALL_REACTION_OFF,
+        .current_ma = 2500,
+        .speed_rpm = 10,
+        .duty_pm = 300,
+        .time_ms = 100,
+        .reduce_pct = 30,
+        .retry_delay_ms = 500,
+        .retry_max = 3,
+    },
+
+    // LINEAR lookup tables (0x0160 - 0x019F), off until enabled
+    .m1_linear = {
+        .table = LINEAR_LUT_IDENTITY,
+    },
+    .m2_linear = {
+        .table = LINEAR_LUT_IDENTITY,
+    },
+
+    // ON/OFF mode (0x01A0 - 0x01BF)
+    .m1_onoff = {
+        .source = ONOFF_SOURCE_REGISTER,
+        .pin = 1,
+        .on_duty = 1000,
+        .soft_start_ms = 200,
+    },
+    .m2_onoff = {
+        .source = ONOFF_SOURCE_REGISTER,
+        .pin = 3,
+        .on_duty = 1000,
+        .soft_start_ms = 200,
+    },
+
+    // Proximity envelope (0x01C0 - 0x01CF), off until a source is selected
+    .proximity = {
+        .source = PROXIMITY_SOURCE_OFF,
+        .pin = 2,
+        .active_low = 1,
+        .distance_cm = PROXIMITY_DISTANCE_FAR,
+        .timeout_ms = 200,
+        .motors = 0x3,
+        .guard = PROXIMITY_GUARD_BOTH,
+        .safe_cm = 20,
+        .slow_cm = 100,
+        .creep_pct = 20,
+        .scale_pct = 100,
+    },
+
+    // PWM post-processing (0x01D0 - 0x01DF), off by default
+    .pwm_post = {
+        .min_pulse_ns = 0,
+        .dither = 0,
+    }
 };
 
 // Register mapping constants
 #define REG_START       0x0000
-#define REG_END         0x0026
+#define REG_END         (TOTAL_REG_COUNT - 1)
 #define REG_SIZE        (REG_END + 1)
 
 // Holding register callback for FreeModbus
@@ -0,0 +1,91 @@
+/*
+ * MotionQueue.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "MotionQueue.h"
+#include "Config.h"
+
+typedef struct {
+    MotionSegment_t segments[CONFIG_MOTION_QUEUE_DEPTH];
+    uint16_t head;          // vi tri ghi tiep
+    uint16_t count;
+    uint16_t index;
+    uint16_t underflows;
+    uint16_t overflows;
+} MotionQueue_t;
+
+static MotionQueue_t queues[MOTOR_COUNT];
+
+bool MotionQueue_Push(uint8_t motor, const MotionSegment_t *segment) {
+    MotionQueue_t *q = &queues[motor];
+
+    if (q->count >= CONFIG_MOTION_QUEUE_DEPTH) {
+        q->overflows++;
+        return false;
+    }
+    q->segments[q->head] = *segment;
+    q->head = (uint16_t)((q->head + 1U) % CONFIG_MOTION_QUEUE_DEPTH);
+    q->count++;
+    return true;
+}
+
+bool MotionQueue_Peek(uint8_t motor, MotionSegment_t *out) {
+    MotionQueue_t *q = &queues[motor];
+    uint16_t tail;
+
+    if (q->count == 0U) {
+        return false;
+    }
+    tail = (uint16_t)((q->head + CONFIG_MOTION_QUEUE_DEPTH - q->count) % CONFIG_MOTION_QUEUE_DEPTH);
+    *out = q->segments[tail];
+    return true;
+}
+
+bool MotionQueue_Pop(uint8_t motor, MotionSegment_t *out) {
+    MotionQueue_t *q = &queues[motor];
+
+    if (!MotionQueue_Peek(motor, out)) {
+        return false;
+    }
+    q->count--;
+    q->index++;
+    return true;
+}
+
+void MotionQueue_Flush(uint8_t motor) {
+    MotionQueue_t *q = &queues[motor];
+
+    q->head = 0;
+    q->count = 0;
+    q->index = 0;
+}
+
+void MotionQueue_ClearCounters(uint8_t motor) {
+    MotionQueue_t *q = &queues[motor];
+
+    q->underflows = 0;
+    q->overflows = 0;
+}
+
+void MotionQueue_NoteUnderflow(uint8_t motor) {
+    queues[motor].underflows++;
+}
+
+uint16_t MotionQueue_GetDepth(uint8_t motor) {
+    return queues[motor].count;
+}
+
+uint16_t MotionQueue_GetIndex(uint8_t motor) {
+    return queues[motor].index;
+}
+
+uint16_t MotionQueue_GetUnderflows(uint8_t motor) {
+    return queues[motor].underflows;
+}
+
+uint16_t MotionQueue_GetOverflows(uint8_t motor) {
+    return queues[motor].overflows;
+}
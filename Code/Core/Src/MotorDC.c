@@ -1,5 +1,1612 @@
 #include "MotorDC.h"
+#include "main.h"
+#include "Config.h"
+#include "FixedPoint.h"
+#include "PWM.h"
+#include "CurrentSense.h"
+#include "Encoder.h"
+#include "BackEMF.h"
+#include "AutoTune.h"
+#include "MotorIdent.h"
+#include "MotionQueue.h"
+#include "DiffDrive.h"
+#include "Thermal.h"
+#include "Stall.h"
+#include "Protection.h"
+#include "LinearMap.h"
+#include "OnOff.h"
+#include "Proximity.h"
+#include "MotorState.h"
+#include "cmsis_os.h"
+#include <string.h>
 
+/*
+ * Don vi gain (register x100 nhu tai lieu Modbus map):
+ *  PID (mode 3)      : Kp 0.01 permille duty / RPM, Ki 0.01 permille / (RPM*s), Kd 0.01 permille / (RPM/s)
+ *  CASCADE (mode 4)  : cung register Kp/Ki/Kd nhung output la mA (0.01 mA / RPM ...)
+ *  POSITION (mode 5) : vong toc do / dong nhu CASCADE, Pos_Kp 0.01 (RPM / (vong/phut)) = 1/s
+ *  GEARED (mode 6)   : nhu POSITION, tham chieu tu Motor 1 (REG_GEAR_x)
+ *  DIFF_DRIVE (mode 7): nhu PID, toc do dat tu dong hoc v/w (REG_DRIVE_x)
+ *  Vong dong dien    : Kp permille duty / A, Ki permille duty / (A*ms)
+ *  Feed-forward (x1000, don vi output cua mode): Kv / RPM, Ka / (RPM/s), static = output
+ *  -> o CASCADE, Kv = Motor_Fv, Ka = Motor_J, static = Motor_Fc (ket qua nhan dang).
+ * Duty trong firmware la Q15 (PWM_DUTY_MAX), 1000 permille = 32768.
+ */
+#define DUTY_PER_MILLE_NUM      32768U
+#define GAIN_SCALE              100U
+#define FF_GAIN_SCALE           1000U
 
-//void _setRuningMode(ModbusRegisterMap_t *modbus_map){
-//}
+DriverSystem_t driver;
+
+static uint32_t _enterCritical(void) {
+	uint32_t primask = __get_PRIMASK();
+	__disable_irq();
+	return primask;
+}
+
+static void _exitCritical(uint32_t primask) {
+	__set_PRIMASK(primask);
+}
+
+// Chan IN1-IN4 (pin 1-4) lam ngo vao so, dung chung voi encoder
+static GPIO_TypeDef * const _inputPorts[4] = { IN1_GPIO_Port, IN2_GPIO_Port, IN3_GPIO_Port, IN4_GPIO_Port };
+static const uint16_t _inputPins[4] = { IN1_Pin, IN2_Pin, IN3_Pin, IN4_Pin };
+
+// true khi chan dang o muc tich cuc; pin ngoai 1-4 doc la khong tich cuc
+static bool _readInputPin(uint16_t pin, bool active_low) {
+	if (pin < 1U || pin > 4U) {
+		return false;
+	}
+	bool high = HAL_GPIO_ReadPin(_inputPorts[pin - 1U], _inputPins[pin - 1U]) == GPIO_PIN_SET;
+	return high != active_low;
+}
+
+static void _initMotor(MotorControl_t *motor, uint8_t id) {
+	motor->_id = id;
+	motor->_regs = MODBUS_MOTOR_REGS(id);
+	motor->_ctrl = MODBUS_MOTOR_CTRL(id);
+	motor->_sched = MODBUS_MOTOR_SCHED(id);
+	motor->_motion = MODBUS_MOTOR_MOTION(id);
+	motor->_thermal = MODBUS_MOTOR_THERMAL(id);
+	motor->_stall = MODBUS_MOTOR_STALL(id);
+	motor->_linear = MODBUS_MOTOR_LINEAR(id);
+	motor->_onoff = MODBUS_MOTOR_ONOFF(id);
+	motor->_mode = 0;                   // ep _setRuningMode ap dung mode trong register
+	motor->_enabled = false;
+	motor->_maxDuty = PWM_DUTY_MAX;
+	motor->_dutyLimit = PWM_DUTY_MAX;
+	PID_Init(&motor->_speedPid, -PWM_DUTY_MAX, PWM_DUTY_MAX);
+	PID_Init(&motor->_currentPid, -PWM_DUTY_MAX, PWM_DUTY_MAX);
+}
+
+void _motorInit() {
+	_initMotor(&driver.motor1, 0);
+	_initMotor(&driver.motor2, 1);
+	MotorState_Init();
+	driver.system_status = 0;
+	driver.error_code = 0;
+}
+
+static bool _isModeEnabled(const MotorControl_t *motor) {
+	const tMotorRegisters *regs = motor->_regs;
+
+	switch (motor->_mode) {
+		case MOTOR_MODE_ONOFF:    return regs->onoff_en != 0U;
+		case MOTOR_MODE_LINEAR:   return regs->linear_en != 0U;
+		case MOTOR_MODE_PID:
+		case MOTOR_MODE_CASCADE:  return regs->pid_en != 0U;
+		case MOTOR_MODE_POSITION: return regs->pid_en != 0U && Encoder_IsEnabled(motor->_id);
+		case MOTOR_MODE_GEARED:
+		case MOTOR_MODE_DIFF_DRIVE: return regs->pid_en != 0U;
+		default:                  return false;
+	}
+}
+
+// Mode co vong dong dien trong (vong toc do ra mA)
+static bool _hasCurrentLoop(MotorMode_t mode) {
+	return mode == MOTOR_MODE_CASCADE || mode == MOTOR_MODE_POSITION || mode == MOTOR_MODE_GEARED;
+}
+
+static void _writeInt32(uint16_t *hi, uint16_t *lo, int32_t value) {
+	*hi = (uint16_t)((uint32_t)value >> 16);
+	*lo = (uint16_t)value;
+}
+
+static int32_t _readInt32(uint16_t hi, uint16_t lo) {
+	return (int32_t)(((uint32_t)hi << 16) | lo);
+}
+
+static bool _dispatch(MotorControl_t *motor, MotorEvent_t event) {
+	return MotorState_Dispatch(motor->_id, event, (uint8_t)motor->_mode, osKernelGetTickCount());
+}
+
+// Loi chot lam motor dung han (REDUCE van chay tiep voi momen giam)
+static bool _faultLatched(const MotorControl_t *motor) {
+	return motor->_regs->error != MOTOR_ERR_NONE && !motor->_stallReduced;
+}
+
+// ACS712 nam o nguon cau H: lay tri tuyet doi, dau theo chieu duty dang xuat
+static int32_t _getMotorCurrent(const MotorControl_t *motor) {
+	int32_t ma = CurrentSense_GetMilliAmps(motor->_id);
+	int32_t sign = (motor->_output != 0) ? motor->_output : motor->_currentRef;
+
+	if (ma < 0) {
+		ma = -ma;
+	}
+	return (sign < 0) ? -ma : ma;
+}
+
+// Toc do thuc: encoder neu co (REG_Mx_ENCODER_PPR != 0), neu khong thi
+// uoc luong back-EMF (REG_Mx_MOTOR_KE != 0)
+static void _updateFeedback(MotorControl_t *motor) {
+	tMotorRegisters *regs = motor->_regs;
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	Encoder_Sample_t sample;
+	BackEMF_Params_t params = {
+		.r_mohm = ctrl->motor_r_mohm,
+		.l_uh = ctrl->motor_l_uh,
+		.ke_uv_per_rpm = ctrl->motor_ke,
+		.vbus_mv = g_modbus_data.vbus_mv,
+	};
+
+	if (ctrl->encoder_ppr != motor->_encoderPpr) {
+		Encoder_Configure(motor->_id, ctrl->encoder_ppr);
+		motor->_encoderPpr = ctrl->encoder_ppr;
+		motor->_encoderCount = 0;                       // Encoder_Configure xoa bo dem
+	}
+	BackEMF_Configure(motor->_id, &params, CurrentSense_GetLoopHz());
+
+	if (Encoder_IsEnabled(motor->_id)) {
+		Encoder_Update(motor->_id);
+		Encoder_GetSample(motor->_id, &sample);
+		motor->_currentSpeed = sample.speed_rpm;
+		ctrl->speed_timestamp = (uint16_t)sample.timestamp_ms;
+		// Vi tri nhieu vong: cong delta (so hoc khong dau, tran 32-bit quay vong)
+		motor->_position = (int32_t)((uint32_t)motor->_position +
+		                             ((uint32_t)sample.count - (uint32_t)motor->_encoderCount));
+		motor->_encoderCount = sample.count;
+		_writeInt32(&motor->_motion->position_hi, &motor->_motion->position_lo, motor->_position);
+	} else if (BackEMF_IsEnabled(motor->_id)) {
+		motor->_currentSpeed = BackEMF_GetSpeed(motor->_id);
+		ctrl->speed_timestamp = (uint16_t)HAL_GetTick();
+	} else {
+		motor->_currentSpeed = regs->actual_speed;      // khong co phan hoi
+		return;
+	}
+	regs->actual_speed = FP_Sat16(motor->_currentSpeed);
+}
+
+// Output vong toc do theo don vi register: permille duty (PID) hoac mA (CASCADE)
+static int32_t _getSpeedLoopOutput(const MotorControl_t *motor) {
+	if (_hasCurrentLoop(motor->_mode)) {
+		return motor->_currentRef;
+	}
+	return ((int32_t)motor->_output * 1000) / (int32_t)DUTY_PER_MILLE_NUM;
+}
+
+static void _setSpeedLoopOutput(MotorControl_t *motor, int32_t value) {
+	if (_hasCurrentLoop(motor->_mode)) {
+		motor->_currentRef = value;
+	} else {
+		// Tran duty cua gioi han momen / I2t (_applyTorqueLimit), nhu ONOFF / LINEAR
+		motor->_output = (int16_t)FP_Saturate(((int64_t)value * DUTY_PER_MILLE_NUM) / 1000,
+		                                      -motor->_dutyLimit, motor->_dutyLimit);
+		PWM_SetDuty(motor->_id, motor->_output);
+	}
+}
+
+// Relay auto-tune thay vong toc do khi REG_Mx_TUNE_COMMAND = 1 (mode PID / CASCADE)
+static bool _runAutoTune(MotorControl_t *motor) {
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	AutoTune_State_t state = AutoTune_GetState(motor->_id);
+	AutoTune_Result_t result;
+	bool pid_mode = (motor->_mode == MOTOR_MODE_PID || motor->_mode == MOTOR_MODE_CASCADE);
+
+	if (ctrl->tune_cmd == 0U || !pid_mode) {
+		ctrl->tune_cmd = 0;
+		if (state == AUTOTUNE_RUNNING) {
+			AutoTune_Abort(motor->_id);
+			PID_Reset(&motor->_speedPid, motor->_currentSpeed,
+			          (motor->_mode == MOTOR_MODE_CASCADE) ? motor->_currentRef : motor->_output);
+		}
+		return false;
+	}
+
+	if (state != AUTOTUNE_RUNNING) {
+		int32_t limit = (motor->_mode == MOTOR_MODE_CASCADE)
+		                    ? motor->_speedPid.out_max
+		                    : ((int32_t)motor->_dutyLimit * 1000) / (int32_t)DUTY_PER_MILLE_NUM;
+		AutoTune_Start(motor->_id, motor->_targetSpeed, _getSpeedLoopOutput(motor),
+		               ctrl->tune_amplitude, ctrl->tune_hysteresis, -limit, limit);
+	}
+
+	_setSpeedLoopOutput(motor, AutoTune_Step(motor->_id, motor->_currentSpeed));
+
+	state = AutoTune_GetState(motor->_id);
+	if (state == AUTOTUNE_RUNNING) {
+		return true;
+	}
+
+	// Ket thuc: ghi gain moi (_setRuningMode quy doi o chu ky sau), chuyen khong giat
+	if (AutoTune_GetResult(motor->_id, &result)) {
+		motor->_regs->kp = result.kp;
+		motor->_regs->ki = result.ki;
+		motor->_regs->kd = result.kd;
+		ctrl->tune_ku = result.ku;
+		ctrl->tune_tu_ms = result.tu_ms;
+	}
+	ctrl->tune_cmd = 0;
+	PID_Reset(&motor->_speedPid, motor->_currentSpeed,
+	          (motor->_mode == MOTOR_MODE_CASCADE) ? motor->_currentRef : motor->_output);
+	return true;
+}
+
+// Nhan dang R, L, Ke, J, ma sat khi REG_Mx_IDENT_COMMAND = 1 (motor phai dang tat)
+static void _getStallParams(const MotorControl_t *motor, Stall_Params_t *params) {
+	const tStallRegisters *stall = motor->_stall;
+
+	params->current_ma = stall->current_ma;
+	params->speed_rpm = stall->speed_rpm;
+	params->duty_pm = stall->duty_pm;
+	params->time_ms = stall->time_ms;
+	params->retry_delay_ms = stall->retry_delay_ms;
+	params->retry_max = stall->retry_max;
+}
+
+// Ket thuc chuoi thu giua chung: cau H ho, MotorState ve DISABLED / FAULT
+static void _abortIdentification(MotorControl_t *motor, MotorEvent_t event) {
+	MotorIdent_Abort(motor->_id);
+	motor->_output = 0;
+	PWM_SetDuty(motor->_id, 0);
+	_dispatch(motor, event);
+}
+
+// Nhan dang lai cau H khi motor dang "tat": MotorState o RUNNING trong luc thu
+// de master (REG_Mx_STATE, System_Status) thay motor dang co dien
+static bool _runIdentification(MotorControl_t *motor) {
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	MotorIdent_State_t state = MotorIdent_GetState(motor->_id);
+	bool running = (state == IDENT_STEP || state == IDENT_RAMP);
+	// ACS712 dung chung: dong cua motor kia lam sai R, L, Ke
+	bool other_running = MOTOR_CONTROL(1 - motor->_id)->_enabled;
+	MotorIdent_Result_t result;
+	Stall_Params_t params;
+
+	if (ctrl->ident_cmd == 0U || motor->_regs->error != MOTOR_ERR_NONE || other_running) {
+		ctrl->ident_cmd = 0;
+		if (running) {
+			_abortIdentification(motor, (motor->_regs->error != MOTOR_ERR_NONE) ? MOTOR_EVENT_FAULT
+			                                                                     : MOTOR_EVENT_DISABLE);
+		}
+		return false;
+	}
+
+	if (!running) {
+		int16_t duty = (int16_t)FP_Saturate(((int64_t)ctrl->ident_duty * DUTY_PER_MILLE_NUM) / 1000,
+		                                    0, motor->_maxDuty);
+		// Tu choi khi motor dang chay hoac motor kia dang dung buffer nhan dang
+		if (motor->_enabled ||
+		    !MotorIdent_Start(motor->_id, duty, g_modbus_data.vbus_mv, Encoder_IsEnabled(motor->_id))) {
+			ctrl->ident_cmd = 0;
+			return false;
+		}
+		_dispatch(motor, MOTOR_EVENT_ENABLE);
+	}
+
+	motor->_output = MotorIdent_Step(motor->_id, motor->_current, motor->_currentSpeed);
+	PWM_SetDuty(motor->_id, motor->_output);
+	state = MotorIdent_GetState(motor->_id);
+
+	// Ket rotor trong luc thu: huy va chot STALL nhu phan ung COAST
+	_getStallParams(motor, &params);
+	if ((state == IDENT_STEP || state == IDENT_RAMP) && motor->_stall->reaction != STALL_REACTION_OFF &&
+	    Stall_Check(motor->_id, &params, motor->_current, motor->_currentSpeed, motor->_output) &&
+	    Stall_Latch(motor->_id, &motor->_regs->error)) {
+		ctrl->ident_cmd = 0;
+		_abortIdentification(motor, MOTOR_EVENT_FAULT);
+		return true;
+	}
+	if (state == IDENT_STEP || state == IDENT_RAMP) {
+		return true;
+	}
+	_dispatch(motor, MOTOR_EVENT_DISABLE);
+
+	if (MotorIdent_GetResult(motor->_id, &result)) {
+		ctrl->motor_r_mohm = result.r_mohm;
+		ctrl->motor_l_uh = result.l_uh;
+		if (result.ke_uv_per_rpm != 0U) {
+			ctrl->motor_ke = result.ke_uv_per_rpm;
+			ctrl->motor_j = result.j_ua_s_per_rpm;
+			ctrl->motor_fv = result.fv_ua_per_rpm;
+			ctrl->motor_fc = result.fc_ma;
+		}
+		g_modbus_data.param_save = PARAM_SAVE_REQUEST;     // luu flash (SystemStatus)
+	}
+	ctrl->ident_cmd = 0;
+	return true;
+}
+
+// Quy doi gain feed-forward sang don vi output cua mode (Q15 duty hoac mA)
+static void _setFeedForward(MotorControl_t *motor) {
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	uint32_t num = _hasCurrentLoop(motor->_mode) ? 1U : DUTY_PER_MILLE_NUM;
+	uint32_t den = _hasCurrentLoop(motor->_mode) ? 1U : 1000U;
+
+	motor->_ffKv = FP_RatioQ(ctrl->ff_kv, num, FF_GAIN_SCALE * den, 16);
+	motor->_ffKa = FP_RatioQ(ctrl->ff_ka, num, FF_GAIN_SCALE * den, 16);
+	motor->_ffStatic = FP_RatioQ(ctrl->ff_static, num, den, 0);
+	motor->_ffKvReg = ctrl->ff_kv;
+	motor->_ffKaReg = ctrl->ff_ka;
+	motor->_ffStaticReg = ctrl->ff_static;
+}
+
+static bool _feedForwardChanged(const MotorControl_t *motor) {
+	const tMotorControlRegisters *ctrl = motor->_ctrl;
+	return ctrl->ff_kv != motor->_ffKvReg || ctrl->ff_ka != motor->_ffKaReg ||
+	       ctrl->ff_static != motor->_ffStaticReg;
+}
+
+// Doc toc do: tham chieu va dao ham cho feed-forward
+// Chieu chuyen dong mode dang yeu cau: 1, -1, 0 = dung yen
+static int32_t _motionSign(const MotorControl_t *motor) {
+	int32_t v;
+
+	switch (motor->_mode) {
+		case MOTOR_MODE_ONOFF:
+		case MOTOR_MODE_LINEAR:      return motor->_direction ? -1 : 1;
+		case MOTOR_MODE_DIFF_DRIVE:  v = g_modbus_data.drive.v_cmd; break;
+		case MOTOR_MODE_POSITION:
+		case MOTOR_MODE_GEARED:      v = motor->_speedRef; break;
+		default:                     v = motor->_targetSpeed; break;
+	}
+	return (v > 0) - (v < 0);
+}
+
+// Vung bao ve khoang cach co ap dung cho motor va chieu chay hien tai khong.
+// DIFF_DRIVE: cam bien gan tren robot, chon mot trong hai banh la gioi han v
+static bool _proximityGuarded(const MotorControl_t *motor) {
+	const tProximityRegisters *prox = &g_modbus_data.proximity;
+	uint16_t mask = (motor->_mode == MOTOR_MODE_DIFF_DRIVE) ? 0x3U : (uint16_t)(1U << motor->_id);
+	int32_t sign;
+
+	if (prox->source == PROXIMITY_SOURCE_OFF || (prox->motors & mask) == 0U) {
+		return false;
+	}
+	sign = _motionSign(motor);
+	switch (prox->guard) {
+		case PROXIMITY_GUARD_FORWARD: return sign > 0;
+		case PROXIMITY_GUARD_REVERSE: return sign < 0;
+		default:                      return true;
+	}
+}
+
+// He so toc do cho phep (Q15), PROXIMITY_SCALE_FULL = khong gioi han
+static int32_t _proximityScale(const MotorControl_t *motor) {
+	return _proximityGuarded(motor) ? Proximity_GetScale() : PROXIMITY_SCALE_FULL;
+}
+
+static int32_t _applyProximity(const MotorControl_t *motor, int32_t value) {
+	return (int32_t)(((int64_t)value * _proximityScale(motor)) >> 15);
+}
+
+// Toc do dat giam theo vung bao ve truoc doc: motor cham lai theo Decel_Limit
+static void _updateReference(MotorControl_t *motor) {
+	motor->_accelerationLimit = motor->_ctrl->accel_limit;
+	motor->_decelerationLimit = motor->_ctrl->decel_limit;
+	motor->_speedRef = Ramp_Update(&motor->_ramp, _applyProximity(motor, motor->_targetSpeed),
+	                               motor->_accelerationLimit, motor->_decelerationLimit,
+	                               CONFIG_CONTROL_LOOP_HZ);
+	motor->_accelRef = Ramp_GetAccel(&motor->_ramp);
+}
+
+// Kv*w_ref + Ka*a_ref + bu ma sat tinh theo chieu w_ref, cong truoc bao hoa
+static int32_t _feedForward(const MotorControl_t *motor) {
+	int64_t ff = ((int64_t)motor->_ffKv * motor->_speedRef +
+	              (int64_t)motor->_ffKa * motor->_accelRef) >> 16;
+
+	if (motor->_speedRef > 0) {
+		ff += motor->_ffStatic;
+	} else if (motor->_speedRef < 0) {
+		ff -= motor->_ffStatic;
+	}
+	return FP_Sat32(ff);
+}
+
+// Quy doi Kp/Ki/Kd register (x100) sang PID_t theo don vi output cua mode
+static void _convertSpeedGains(const MotorControl_t *motor, uint16_t kp, uint16_t ki, uint16_t kd,
+                               PID_Gains_t *gains) {
+	const uint32_t hz = CONFIG_CONTROL_LOOP_HZ;
+
+	if (_hasCurrentLoop(motor->_mode)) {
+		gains->kp = FP_RatioQ(kp, 1U, GAIN_SCALE, 16);
+		gains->ki = FP_RatioQ(ki, 1U, GAIN_SCALE * hz, 24);
+		gains->kd = FP_RatioQ(kd, hz, GAIN_SCALE, 16);
+	} else {
+		gains->kp = FP_RatioQ(kp, DUTY_PER_MILLE_NUM, GAIN_SCALE * 1000U, 16);
+		gains->ki = FP_RatioQ(ki, DUTY_PER_MILLE_NUM, GAIN_SCALE * 1000U * hz, 24);
+		gains->kd = FP_RatioQ(kd, DUTY_PER_MILLE_NUM * hz, GAIN_SCALE * 1000U, 16);
+	}
+}
+
+// Nap bang gain (REG_Mx_SCHED_x); bang loi hoac source = 0 -> dung Kp/Ki/Kd co dinh
+static void _setGainSchedule(MotorControl_t *motor) {
+	tGainScheduleRegisters *sched = motor->_sched;
+	PID_Gains_t gains;
+	uint8_t count = (sched->count > GAIN_SCHED_MAX_POINTS) ? 0U : (uint8_t)sched->count;
+	bool ok = false;
+
+	if (sched->source == GAIN_SCHED_SOURCE_SPEED || sched->source == GAIN_SCHED_SOURCE_CURRENT) {
+		// Quy doi tung diem thang vao bang (khong giu ban sao tren stack task)
+		for (uint8_t i = 0; i < count; i++) {
+			_convertSpeedGains(motor, sched->points[i].kp, sched->points[i].ki,
+			                   sched->points[i].kd, &gains);
+			GainSchedule_SetPoint(&motor->_schedule, i, sched->points[i].x, &gains);
+		}
+		ok = GainSchedule_Commit(&motor->_schedule, count);
+	} else {
+		GainSchedule_Disable(&motor->_schedule);
+	}
+
+	// Tat bang: quay ve gain co dinh, chuyen muot nhu khi master ghi Kp
+	if (!ok) {
+		_convertSpeedGains(motor, motor->_kp, motor->_ki, motor->_kd, &gains);
+		PID_SetGainsBumpless(&motor->_speedPid, gains.kp, gains.ki, gains.kd);
+	}
+	sched->active = ok ? 0U : GAIN_SCHED_ACTIVE_NONE;
+	motor->_schedSource = sched->source;
+	motor->_schedCount = sched->count;
+	memcpy(motor->_schedPoints, sched->points, sizeof(motor->_schedPoints));
+}
+
+static bool _gainScheduleChanged(const MotorControl_t *motor) {
+	const tGainScheduleRegisters *sched = motor->_sched;
+	return sched->source != motor->_schedSource || sched->count != motor->_schedCount ||
+	       memcmp(sched->points, motor->_schedPoints, sizeof(motor->_schedPoints)) != 0;
+}
+
+static bool _linearMapChanged(const MotorControl_t *motor) {
+	const tLinearRegisters *lin = motor->_linear;
+	return lin->enable != motor->_linEnable || lin->deadband != motor->_linDeadband ||
+	       memcmp(lin->table, motor->_linTable, sizeof(motor->_linTable)) != 0;
+}
+
+// Noi suy gain moi chu ky; PID_SetGainsBumpless giu output lien tuc khi doi doan
+static void _applyGainSchedule(MotorControl_t *motor) {
+	PID_Gains_t gains;
+	int32_t x;
+
+	if (!GainSchedule_IsEnabled(&motor->_schedule)) {
+		return;
+	}
+	x = (motor->_schedSource == GAIN_SCHED_SOURCE_CURRENT) ? motor->_current : motor->_currentSpeed;
+	if (x < 0) {
+		x = -x;
+	}
+	motor->_sched->active = GainSchedule_Evaluate(&motor->_schedule, x, &gains);
+	PID_SetGainsBumpless(&motor->_speedPid, gains.kp, gains.ki, gains.kd);
+}
+
+// Tham chieu vi tri / khop / v-w cua mode bat dau tu trang thai hien tai
+static void _resetReferences(MotorControl_t *motor) {
+	MoveProfile_Reset(&motor->_profile, motor->_position);    // POSITION: giu vi tri hien tai
+	motor->_positionRef = motor->_position;
+	motor->_gearSource = 0xFFFFU;                              // GEARED: vao khop o tick dau
+	if (motor->_mode == MOTOR_MODE_DIFF_DRIVE) {
+		const MotorControl_t *other = MOTOR_CONTROL(1 - motor->_id);
+		if (!other->_enabled || other->_mode != MOTOR_MODE_DIFF_DRIVE) {
+			DiffDrive_ResetCommand();                          // banh dau tien: doc v/w tu 0
+		}
+	}
+}
+
+// Bat output tu 0 (bat motor, het vat can)
+static void _startOutput(MotorControl_t *motor) {
+	uint32_t primask = _enterCritical();
+	PID_Reset(&motor->_speedPid, motor->_currentSpeed, 0);
+	PID_Reset(&motor->_currentPid, 0, 0);
+	Ramp_Reset(&motor->_ramp, motor->_currentSpeed);
+	_resetReferences(motor);
+	motor->_speedRef = motor->_currentSpeed;
+	motor->_accelRef = 0;
+	motor->_currentRef = 0;
+	motor->_output = 0;
+	motor->_proxHeld = false;
+	motor->_enabled = true;
+	_exitCritical(primask);
+}
+
+void _setEnableMotor(MotorControl_t *motor) {
+	if (_dispatch(motor, MOTOR_EVENT_ENABLE)) {
+		_startOutput(motor);
+	}
+}
+
+// Roi mode cu khi doi mode dang chay: huy nhung gi chi mode cu dung
+static void _leaveMode(MotorControl_t *motor, MotorMode_t previous) {
+	AutoTune_Abort(motor->_id);
+	if (previous == MOTOR_MODE_POSITION) {
+		MotionQueue_Flush(motor->_id);
+		motor->_queueStreaming = false;
+		motor->_queueStarved = false;
+	}
+	if (previous == MOTOR_MODE_GEARED) {
+		driver.gear_correction = 0;
+	}
+	if (previous == MOTOR_MODE_ONOFF) {
+		OnOff_Stop(motor->_id, osKernelGetTickCount());
+	}
+}
+
+static void _getOnOffParams(const MotorControl_t *motor, OnOff_Params_t *params) {
+	const tOnOffRegisters *cfg = motor->_onoff;
+
+	params->on_duty_pm = cfg->on_duty;
+	params->soft_start_ms = cfg->soft_start_ms;
+	params->min_on_ms = cfg->min_on_ms;
+	params->min_off_ms = cfg->min_off_ms;
+}
+
+// Duty LINEAR (Q15, >= 0) cho linear_input 0-1000: bang tra hoac ti le thang
+static int32_t _linearDuty(const MotorControl_t *motor, uint32_t input) {
+	if (input > 1000U) {
+		input = 1000U;
+	}
+	if (LinearMap_IsEnabled(motor->_id)) {
+		return LinearMap_Lookup(motor->_id, (uint16_t)input);
+	}
+	return (int32_t)((input * (uint32_t)motor->_maxDuty) / 1000U);
+}
+
+// linear_input nho nhat cho duty >= duty (ban do khong giam: tim nhi phan, ~10 lan tra)
+static uint16_t _linearInputFor(const MotorControl_t *motor, int32_t duty) {
+	uint32_t lo = 0, hi = 1000U;
+
+	while (lo < hi) {
+		uint32_t mid = (lo + hi) / 2U;
+		if (_linearDuty(motor, mid) < duty) {
+			lo = mid + 1U;
+		} else {
+			hi = mid;
+		}
+	}
+	return (uint16_t)lo;
+}
+
+// ONOFF / LINEAR: doc toc do bam theo toc do do duoc de khi doi sang mode vong kin
+// tham chieu bat dau tu toc do dang quay
+static void _trackSpeedReference(MotorControl_t *motor) {
+	Ramp_Reset(&motor->_ramp, motor->_currentSpeed);
+	motor->_speedRef = motor->_currentSpeed;
+	motor->_accelRef = 0;
+}
+
+// Doi mode khi dang chay (output tracking): mode moi tiep tuc tu duty / dong dat
+// dang xuat. Vong kin: tich phan tinh nguoc (PID_Track) theo gain / feed-forward
+// cua mode moi nen tick dau ra dung output cu. Doc toc do giu nguyen neu mode cu
+// cung chay doc (PID, CASCADE), mode khac bat dau tu toc do do duoc.
+// ONOFF: soft-start tiep tu duty hien tai. LINEAR: linear_input dat theo duty hien tai
+static void _handoverMode(MotorControl_t *motor, MotorMode_t previous) {
+	int32_t duty = motor->_output;
+	int32_t magnitude = (duty < 0) ? -duty : duty;
+	int32_t current_ref = _hasCurrentLoop(previous) ? motor->_currentRef : motor->_current;
+	bool ramped = previous == MOTOR_MODE_PID || previous == MOTOR_MODE_CASCADE;
+	OnOff_Params_t params;
+
+	if (!ramped) {
+		_trackSpeedReference(motor);
+	}
+	uint32_t primask = _enterCritical();
+	if (_hasCurrentLoop(motor->_mode)) {
+		PID_Track(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed, _feedForward(motor), current_ref);
+		motor->_currentRef = motor->_speedPid.output;
+		PID_Track(&motor->_currentPid, motor->_currentRef, motor->_current, 0, duty);
+	} else {
+		PID_Track(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed, _feedForward(motor), duty);
+		motor->_currentRef = 0;
+	}
+	_resetReferences(motor);
+	_exitCritical(primask);
+
+	if (motor->_mode == MOTOR_MODE_ONOFF) {
+		_getOnOffParams(motor, &params);
+		OnOff_Resume(motor->_id, &params, magnitude, osKernelGetTickCount());
+	} else if (motor->_mode == MOTOR_MODE_LINEAR) {
+		motor->_regs->linear_input = _linearInputFor(motor, magnitude);
+	}
+}
+
+void _setRuningMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	MotorMode_t mode = (MotorMode_t)regs->mode;
+
+	if (mode < MOTOR_MODE_ONOFF || mode > MOTOR_MODE_DIFF_DRIVE ||
+	    (mode == MOTOR_MODE_GEARED && motor->_id == 0)) {
+		regs->mode = motor->_mode;      // gia tri khong hop le: giu mode dang chay
+		return;
+	}
+
+	if (mode != motor->_mode) {
+		// Dang chay (ke ca dang giu do vat can): doi mode khong dung motor
+		MotorMode_t previous = motor->_mode;
+		bool live = motor->_enabled && !motor->_stopping;
+
+		if (live) {
+			_leaveMode(motor, previous);
+		} else {
+			_setDisableMotor(motor);
+		}
+		motor->_mode = mode;
+		switch (mode) {
+			case MOTOR_MODE_ONOFF:   _setOnOffMode(regs, motor); break;
+			case MOTOR_MODE_LINEAR:  _setLinearMode(regs, motor); break;
+			case MOTOR_MODE_PID:     _setPIDMode(regs, motor); break;
+			case MOTOR_MODE_CASCADE: _setCascadeMode(regs, motor); break;
+			case MOTOR_MODE_POSITION: _setPositionMode(regs, motor); break;
+			case MOTOR_MODE_GEARED:   _setGearedMode(regs, motor); break;
+			case MOTOR_MODE_DIFF_DRIVE: _setDiffDriveMode(regs, motor); break;
+		}
+		if (live) {
+			_handoverMode(motor, previous);
+			_dispatch(motor, MOTOR_EVENT_MODE);
+		}
+		return;
+	}
+
+	// Master doi gain khi dang chay: quy doi lai, giu nguyen trang thai tich phan
+	if ((mode == MOTOR_MODE_PID || mode == MOTOR_MODE_DIFF_DRIVE) &&
+	    (regs->kp != motor->_kp || regs->ki != motor->_ki || regs->kd != motor->_kd ||
+	     _feedForwardChanged(motor))) {
+		_setPIDMode(regs, motor);
+	} else if (_hasCurrentLoop(mode) &&
+	           (regs->kp != motor->_kp || regs->ki != motor->_ki || regs->kd != motor->_kd ||
+	            motor->_ctrl->cur_kp != motor->_curKp || motor->_ctrl->cur_ki != motor->_curKi ||
+	            motor->_ctrl->current_limit_ma != motor->_currentLimit ||
+	            CurrentSense_GetLoopHz() != motor->_currentLoopHz || _feedForwardChanged(motor) ||
+	            ((mode == MOTOR_MODE_POSITION || mode == MOTOR_MODE_GEARED) &&
+	             (motor->_motion->pos_kp != motor->_posKpReg ||
+	              motor->_ctrl->encoder_ppr != motor->_posPpr)))) {
+		if (mode == MOTOR_MODE_POSITION) {
+			_setPositionMode(regs, motor);
+		} else if (mode == MOTOR_MODE_GEARED) {
+			_setGearedMode(regs, motor);
+		} else {
+			_setCascadeMode(regs, motor);
+		}
+	} else if (mode == MOTOR_MODE_LINEAR && _linearMapChanged(motor)) {
+		_setLinearMode(regs, motor);
+	} else if (mode != MOTOR_MODE_ONOFF && mode != MOTOR_MODE_LINEAR && _gainScheduleChanged(motor)) {
+		_setGainSchedule(motor);
+	}
+}
+
+// Tat output ngay; event ghi vao log neu motor dang bat
+static void _stopOutput(MotorControl_t *motor, MotorEvent_t event) {
+	AutoTune_Abort(motor->_id);
+	if (motor->_enabled) {
+		MotionQueue_Flush(motor->_id);      // chuoi doan bi ngat: khong chay tiep khi bat lai
+		motor->_queueStreaming = false;
+		motor->_queueStarved = false;
+	}
+	if (motor->_id == 1) {
+		driver.gear_correction = 0;         // Motor 1 khong con doi Motor 2
+	}
+
+	bool was_running = motor->_enabled;
+	if (was_running) {
+		_dispatch(motor, event);
+	}
+	uint32_t primask = _enterCritical();
+	motor->_enabled = false;
+	motor->_stopping = false;
+	motor->_currentRef = 0;
+	motor->_output = 0;
+	PWM_SetDuty(motor->_id, 0);
+	_exitCritical(primask);
+	if (motor->_mode == MOTOR_MODE_ONOFF) {
+		OnOff_Stop(motor->_id, osKernelGetTickCount());  // min_off tinh tu luc nay
+	}
+
+	// Co loi: luon de cau H ho (STALL_REACTION_BRAKE tu ham rieng)
+	if (was_running && motor->_ctrl->stop_mode == STOP_MODE_BRAKE &&
+	    motor->_regs->error == MOTOR_ERR_NONE) {
+		uint32_t strength = (motor->_ctrl->brake_duty > 1000U) ? 1000U : motor->_ctrl->brake_duty;
+		PWM_Brake(motor->_id, (int16_t)((strength * PWM_DUTY_MAX) / 1000U));
+	}
+}
+
+void _setDisableMotor(MotorControl_t *motor) {
+	_stopOutput(motor, _faultLatched(motor) ? MOTOR_EVENT_FAULT : MOTOR_EVENT_DISABLE);
+}
+
+// Master tat motor khi dang chay (STOP_MODE_DECEL): giu _enabled, _runControlledStop
+// dua motor ve 0 roi moi goi _setDisableMotor
+static void _startControlledStop(MotorControl_t *motor) {
+	AutoTune_Abort(motor->_id);
+	MotionQueue_Flush(motor->_id);
+	motor->_queueStreaming = false;
+	motor->_queueStarved = false;
+	if (motor->_id == 1) {
+		driver.gear_correction = 0;
+	}
+	Ramp_Reset(&motor->_ramp, motor->_speedRef);    // POSITION / GEARED / DIFF: tu tham chieu dang chay
+	motor->_stopTicks = 0;
+	motor->_stopping = true;
+	_dispatch(motor, MOTOR_EVENT_STOP);
+}
+
+// Toc do dat (mode vong toc do) hoac duty (ONOFF / LINEAR) ve 0 theo Stop_Decel.
+// ACS712 o nguon cau H: dong am = nang luong hoi tiep ve bus. Vuot Regen_Limit
+// thi giu nguyen tham chieu tick do de khong bom dien ap nguon.
+// Tra ve true khi da dung han
+static bool _runControlledStop(MotorControl_t *motor) {
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	int32_t regen = -(int32_t)CurrentSense_GetMilliAmps(motor->_id);
+	bool hold = ctrl->regen_limit_ma != 0U && regen > (int32_t)ctrl->regen_limit_ma;
+	int32_t duty, step;
+
+	if (motor->_mode == MOTOR_MODE_ONOFF || motor->_mode == MOTOR_MODE_LINEAR) {
+		// Phan nghin duty / s -> Q15 / tick
+		step = (ctrl->stop_decel == 0U) ? PWM_DUTY_MAX :
+		       (int32_t)(((uint32_t)ctrl->stop_decel * PWM_DUTY_MAX) / (1000U * CONFIG_CONTROL_LOOP_HZ)) + 1;
+		if (!hold) {
+			duty = motor->_output;
+			if (duty > step) {
+				duty -= step;
+			} else if (duty < -step) {
+				duty += step;
+			} else {
+				duty = 0;
+			}
+			motor->_output = (int16_t)duty;
+			PWM_SetDuty(motor->_id, motor->_output);
+		}
+		return motor->_output == 0;
+	}
+
+	if (!hold) {
+		uint32_t decel = (ctrl->stop_decel != 0U) ? ctrl->stop_decel : ctrl->decel_limit;
+		motor->_speedRef = Ramp_Update(&motor->_ramp, 0, decel, decel, CONFIG_CONTROL_LOOP_HZ);
+		motor->_accelRef = Ramp_GetAccel(&motor->_ramp);
+	} else {
+		motor->_accelRef = 0;
+	}
+	_applyGainSchedule(motor);
+	if (_hasCurrentLoop(motor->_mode)) {
+		motor->_currentRef = PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+		                                  _feedForward(motor));
+	} else {
+		motor->_output = (int16_t)PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+		                                       _feedForward(motor));
+		PWM_SetDuty(motor->_id, motor->_output);
+	}
+
+	if (motor->_speedRef != 0) {
+		return false;
+	}
+	if (motor->_stopTicks < CONFIG_STOP_TIMEOUT_MS) {
+		motor->_stopTicks++;
+	}
+	return (motor->_currentSpeed <= (int32_t)CONFIG_STOP_SPEED_RPM &&
+	        motor->_currentSpeed >= -(int32_t)CONFIG_STOP_SPEED_RPM) ||
+	       motor->_stopTicks >= CONFIG_STOP_TIMEOUT_MS;
+}
+
+void _setOnOffMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	(void)regs;
+	// Thong so doc truc tiep tu REG_Mx_ONOFF_x moi tick; chi xoa nho tre
+	motor->_onOffDemand = false;
+}
+
+void _setLinearMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	tLinearRegisters *lin = motor->_linear;
+	(void)regs;
+
+	// Bang loi: quay ve ti le thang, bao qua REG_Mx_LIN_STATE
+	if (lin->enable != 0U) {
+		lin->state = LinearMap_Configure(motor->_id, lin->table, lin->deadband) ?
+		             LINEAR_LUT_STATE_ACTIVE : LINEAR_LUT_STATE_INVALID;
+	} else {
+		LinearMap_Disable(motor->_id);
+		lin->state = LINEAR_LUT_STATE_OFF;
+	}
+	motor->_linEnable = lin->enable;
+	motor->_linDeadband = lin->deadband;
+	memcpy(motor->_linTable, lin->table, sizeof(motor->_linTable));
+}
+
+void _setPIDMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	// Output: duty Q15; gain co dinh ap dung qua _setGainSchedule khi khong co bang
+	PID_SetLimits(&motor->_speedPid, -motor->_maxDuty, motor->_maxDuty);
+	motor->_kp = regs->kp;
+	motor->_ki = regs->ki;
+	motor->_kd = regs->kd;
+	_setFeedForward(motor);
+	_setGainSchedule(motor);
+}
+
+void _setCascadeMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	uint32_t current_hz = CurrentSense_GetLoopHz();
+	int32_t limit = (ctrl->current_limit_ma > INT16_MAX) ? INT16_MAX : ctrl->current_limit_ma;
+	int32_t cur_kp, cur_ki;
+
+	if (current_hz == 0U) {
+		current_hz = CONFIG_CURRENT_LOOP_HZ;
+	}
+
+	// Vong ngoai: output la dong dat (mA), gioi han dong = bao hoa cua vong toc do
+	PID_SetLimits(&motor->_speedPid, -limit, limit);
+
+	// Vong trong: PI dong dien -> duty Q15, quy doi theo tan so vong nhanh thuc te
+	cur_kp = FP_RatioQ(ctrl->cur_kp, DUTY_PER_MILLE_NUM, 1000U * 1000U, 16);
+	cur_ki = FP_RatioQ(ctrl->cur_ki, DUTY_PER_MILLE_NUM, 1000U * current_hz, 24);
+
+	uint32_t primask = _enterCritical();
+	PID_SetLimits(&motor->_currentPid, -motor->_maxDuty, motor->_maxDuty);
+	PID_SetGains(&motor->_currentPid, cur_kp, cur_ki, 0);
+	_exitCritical(primask);
+
+	motor->_kp = regs->kp;
+	motor->_ki = regs->ki;
+	motor->_kd = regs->kd;
+	motor->_curKp = ctrl->cur_kp;
+	motor->_curKi = ctrl->cur_ki;
+	motor->_currentLimit = ctrl->current_limit_ma;
+	motor->_currentLoopHz = current_hz;
+	_setFeedForward(motor);
+	_setGainSchedule(motor);
+}
+
+void _setPositionMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	tMotionRegisters *motion = motor->_motion;
+	uint32_t counts_per_rev = 4U * motor->_ctrl->encoder_ppr;
+
+	_setCascadeMode(regs, motor);
+
+	// RPM = Kp/100 [1/s] * sai so [xung] * 60 / (xung/vong)
+	motor->_posKp = (counts_per_rev != 0U) ?
+	                FP_RatioQ(motion->pos_kp, 60U, GAIN_SCALE * counts_per_rev, 16) : 0;
+	motor->_posKpReg = motion->pos_kp;
+	motor->_posPpr = motor->_ctrl->encoder_ppr;
+}
+
+void _setGearedMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	// Cung vong vi tri / toc do / dong nhu POSITION, chi khac nguon tham chieu
+	_setPositionMode(regs, motor);
+}
+
+void _setDiffDriveMode(tMotorRegisters *regs, MotorControl_t *motor) {
+	// Moi banh la mot vong toc do -> duty (mode 3): cam bien dong dung chung
+	// khong tach duoc dong tung banh khi hai banh cung chay
+	_setPIDMode(regs, motor);
+}
+
+// Odometry (chung cho 2 banh): reset theo lenh, xuat ra REG_DRIVE_x
+static void _publishDiffDrive(void) {
+	tDriveRegisters *drive = &g_modbus_data.drive;
+	DiffDrive_Odometry_t odom;
+
+	if (drive->odom_reset != 0U) {
+		DiffDrive_ResetOdometry();
+		drive->odom_reset = 0;
+	}
+	DiffDrive_GetOdometry(&odom);
+	_writeInt32(&drive->odom_x_hi, &drive->odom_x_lo, odom.x_mm);
+	_writeInt32(&drive->odom_y_hi, &drive->odom_y_lo, odom.y_mm);
+	drive->odom_theta = odom.theta_mrad;
+	drive->v_actual = odom.v_mm_s;
+	drive->w_actual = odom.w_mrad_s;
+	drive->status = DiffDrive_IsSaturated() ? DRIVE_STATUS_SATURATED : 0U;
+}
+
+// Log chuyen trang thai (chung cho 2 motor) va trang thai tong hop driver.system_status
+static void _publishStateMachine(void) {
+	tStateMachineRegisters *msm = &g_modbus_data.msm;
+	MotorState_LogEntry_t entry;
+	uint8_t count = 0;
+	uint8_t status = 0;
+
+	if (msm->log_clear != 0U) {
+		MotorState_ClearLog();
+		msm->log_clear = 0;
+	}
+	for (uint8_t i = 0; i < MOTOR_STATE_LOG_DEPTH; i++) {
+		tStateLogRegisters *out = &msm->log[i];
+		if (MotorState_GetLog(i, &entry)) {
+			_writeInt32(&out->time_hi, &out->time_lo, (int32_t)entry.time_ms);
+			out->transition = (uint16_t)(((uint16_t)entry.motor << 12) | ((uint16_t)(entry.mode & 0xFU) << 8) |
+			                             ((uint16_t)entry.from << 4) | entry.to);
+			out->event = entry.event;
+			count++;
+		} else {
+			memset(out, 0, sizeof(*out));
+		}
+	}
+	msm->log_count = count;
+	msm->transitions = MotorState_GetTransitions();
+	msm->rejected = MotorState_GetRejected();
+
+	// 0 = Idle, 1 = Running, 2 = Fault
+	for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+		MotorState_t state = MotorState_Get(i);
+		if (state == MOTOR_STATE_FAULT || state == MOTOR_STATE_RECOVERING) {
+			status = 2;
+		} else if (state != MOTOR_STATE_DISABLED && status == 0U) {
+			status = 1;
+		}
+	}
+	driver.system_status = status;
+	g_modbus_data.system_status = status;
+}
+
+// Motor 1: bu dong bo tu Motor 2 (GEARED) chi lam cham lai, khong dao chieu
+static void _applyGearCorrection(MotorControl_t *motor) {
+	int32_t correction = driver.gear_correction;
+	int32_t ref = motor->_speedRef;
+
+	if (motor->_id != 0 || correction == 0) {
+		return;
+	}
+	if (ref > 0) {
+		motor->_speedRef = FP_Saturate((int64_t)ref + correction, 0, ref);
+	} else if (ref < 0) {
+		motor->_speedRef = FP_Saturate((int64_t)ref + correction, ref, 0);
+	}
+}
+
+// Lenh di chuyen (REG_Mx_MOVE_COMMAND), tu xoa sau khi xu ly
+static void _handleMoveCommand(MotorControl_t *motor) {
+	tMotionRegisters *motion = motor->_motion;
+	int32_t target = _readInt32(motion->target_pos_hi, motion->target_pos_lo);
+	uint32_t counts_per_rev = 4U * motor->_ctrl->encoder_ppr;
+	bool active = motor->_enabled && motor->_mode == MOTOR_MODE_POSITION;
+
+	switch (motion->move_cmd) {
+		case MOVE_CMD_ABSOLUTE:
+		case MOVE_CMD_RELATIVE:
+			if (!active) {
+				break;
+			}
+			MotionQueue_Flush(motor->_id);
+			motor->_queueStreaming = false;
+			motor->_queueStarved = false;
+			if (motion->move_cmd == MOVE_CMD_RELATIVE) {
+				target = (int32_t)((uint32_t)MoveProfile_GetTarget(&motor->_profile) + (uint32_t)target);
+			}
+			MoveProfile_Start(&motor->_profile, target, motion->move_vmax, motion->move_accel,
+			                  counts_per_rev, CONFIG_CONTROL_LOOP_HZ);
+			break;
+		case MOVE_CMD_STOP:
+			MotionQueue_Flush(motor->_id);
+			motor->_queueStreaming = false;
+			motor->_queueStarved = false;
+			if (active) {
+				MoveProfile_Stop(&motor->_profile);
+			}
+			break;
+		case MOVE_CMD_SET_POSITION:
+			// Chi khi dung yen: dich he toa do, tham chieu di theo nen khong giat
+			if (!active || MoveProfile_IsDone(&motor->_profile)) {
+				motor->_position = target;
+				motor->_positionRef = target;
+				MoveProfile_Reset(&motor->_profile, target);
+				_writeInt32(&motion->position_hi, &motion->position_lo, target);
+			}
+			break;
+		case MOVE_CMD_CLEAR_COUNTERS:
+			MotionQueue_ClearCounters(motor->_id);
+			break;
+		default:
+			break;
+	}
+	motion->move_cmd = MOVE_CMD_NONE;
+}
+
+// Nap cac doan staging vao hang doi (REG_Mx_QUEUE_PUSH = so doan), nhan ca khi motor tat
+static void _handleQueuePush(MotorControl_t *motor) {
+	tMotionRegisters *motion = motor->_motion;
+	uint16_t n = motion->queue_push;
+
+	if (n == 0U) {
+		return;
+	}
+	if (n > MOTION_QUEUE_STAGING) {
+		n = MOTION_QUEUE_STAGING;
+	}
+	for (uint16_t i = 0; i < n; i++) {
+		MotionSegment_t segment = {
+			.target = _readInt32(motion->staging[i].target_pos_hi, motion->staging[i].target_pos_lo),
+			.vmax_rpm = motion->staging[i].vmax,
+			.accel_rpm_s = motion->staging[i].accel,
+		};
+		MotionQueue_Push(motor->_id, &segment);
+	}
+	motion->queue_push = 0;
+}
+
+// Doan tiep theo: khi doan hien tai xong, hoac noi tiep khong dung neu doan
+// dang phanh va target moi nam tiep theo cung chieu chuyen dong.
+// Underflow: hang doi can khi doan bat dau phanh va master nap doan tiep theo
+// trong luc truc con chay. Doan cuoi chay het ve 0 khong tinh
+static void _feedMotionQueue(MotorControl_t *motor) {
+	MoveProfile_t *profile = &motor->_profile;
+	MotionSegment_t segment;
+	int32_t velocity = MoveProfile_GetVelocity(profile);
+	int32_t ahead;
+	bool take;
+
+	if (!MotionQueue_Peek(motor->_id, &segment)) {
+		if (!motor->_queueStreaming) {
+			return;
+		}
+		if (MoveProfile_IsDone(profile)) {
+			motor->_queueStreaming = false;
+			motor->_queueStarved = false;
+		} else if (MoveProfile_IsDecelerating(profile) && velocity != 0) {
+			motor->_queueStarved = true;
+		}
+		return;
+	}
+
+	ahead = (int32_t)((uint32_t)segment.target - (uint32_t)MoveProfile_GetTarget(profile));
+	take = MoveProfile_IsDone(profile) ||
+	       (MoveProfile_IsDecelerating(profile) &&
+	        ((velocity > 0 && ahead > 0) || (velocity < 0 && ahead < 0)));
+	if (!take) {
+		return;
+	}
+	if (motor->_queueStarved && !MoveProfile_IsDone(profile)) {
+		MotionQueue_NoteUnderflow(motor->_id);
+	}
+	MotionQueue_Pop(motor->_id, &segment);
+	MoveProfile_Start(profile, segment.target, segment.vmax_rpm, segment.accel_rpm_s,
+	                  4U * motor->_ctrl->encoder_ppr, CONFIG_CONTROL_LOOP_HZ);
+	motor->_queueStreaming = true;
+	motor->_queueStarved = false;
+}
+
+
+// Lenh bat cua ONOFF. VALUE: tre giua on_level va off_level, trong dai tre giu lenh cu
+static bool _onOffDemand(MotorControl_t *motor) {
+	const tOnOffRegisters *cfg = motor->_onoff;
+	bool demand = motor->_onOffDemand;
+
+	switch (cfg->source) {
+		case ONOFF_SOURCE_VALUE:
+			if (cfg->on_level >= cfg->off_level) {
+				if (cfg->value >= cfg->on_level) {
+					demand = true;
+				} else if (cfg->value <= cfg->off_level) {
+					demand = false;
+				}
+			} else {
+				if (cfg->value <= cfg->on_level) {
+					demand = true;
+				} else if (cfg->value >= cfg->off_level) {
+					demand = false;
+				}
+			}
+			break;
+		case ONOFF_SOURCE_PIN:
+			demand = _readInputPin(cfg->pin, cfg->active_low != 0U);
+			break;
+		default:
+			demand = true;                  // REGISTER: ONOFF_Enable la lenh bat
+			break;
+	}
+	motor->_onOffDemand = demand;
+	return demand;
+}
+
+void _runOnOffMode(MotorControl_t *motor) {
+	OnOff_Params_t params;
+	int32_t duty;
+
+	_getOnOffParams(motor, &params);
+	duty = OnOff_Update(motor->_id, &params, _onOffDemand(motor), osKernelGetTickCount());
+
+	duty = _applyProximity(motor, duty);
+	if (duty > motor->_dutyLimit) {
+		duty = motor->_dutyLimit;
+	}
+	motor->_output = (int16_t)(motor->_direction ? -duty : duty);
+	PWM_SetDuty(motor->_id, motor->_output);
+	_trackSpeedReference(motor);
+}
+
+void _runLinearMode(MotorControl_t *motor) {
+	int32_t duty = _linearDuty(motor, motor->_regs->linear_input);
+
+	duty = _applyProximity(motor, duty);
+	if (duty > motor->_dutyLimit) {
+		duty = motor->_dutyLimit;
+	}
+	motor->_output = (int16_t)(motor->_direction ? -duty : duty);
+	PWM_SetDuty(motor->_id, motor->_output);
+	_trackSpeedReference(motor);
+}
+
+void _runPIDMode(MotorControl_t *motor) {
+	_updateReference(motor);
+	_applyGearCorrection(motor);
+	_applyGainSchedule(motor);
+	int32_t duty = PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+	                            _feedForward(motor));
+	motor->_output = (int16_t)duty;
+	PWM_SetDuty(motor->_id, motor->_output);
+}
+
+void _runCascadeMode(MotorControl_t *motor) {
+	// Chi cap nhat dong dat; duty do _runCurrentLoop xuat o tan so vong nhanh
+	_updateReference(motor);
+	_applyGearCorrection(motor);
+	_applyGainSchedule(motor);
+	motor->_currentRef = PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+	                                  _feedForward(motor));
+}
+
+void _runPositionMode(MotorControl_t *motor) {
+	int32_t error, velocity;
+
+	_feedMotionQueue(motor);
+
+	// Vi tri -> toc do: van toc bien dang (feed-forward) + P theo sai so bam
+	motor->_positionRef = MoveProfile_Update(&motor->_profile);
+	error = (int32_t)((uint32_t)motor->_positionRef - (uint32_t)motor->_position);
+	velocity = MoveProfile_GetVelocity(&motor->_profile) + FP_Mul(error, motor->_posKp, 16);
+	motor->_speedRef = FP_Saturate(velocity, -INT16_MAX, INT16_MAX);
+	motor->_accelRef = MoveProfile_GetAccel(&motor->_profile);
+	motor->_motion->following_error = FP_Sat16(error);
+	_applyGearCorrection(motor);
+
+	_applyGainSchedule(motor);
+	motor->_currentRef = PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+	                                  _feedForward(motor));
+}
+
+void _runGearedMode(MotorControl_t *motor) {
+	tCouplingRegisters *gear = &g_modbus_data.coupling;
+	const MotorControl_t *master = &driver.motor1;
+	int32_t num = gear->numerator;
+	int32_t den = (gear->denominator != 0U) ? gear->denominator : 1;
+	int32_t offset = _readInt32(gear->offset_hi, gear->offset_lo);
+	uint32_t counts_per_rev = 4U * motor->_ctrl->encoder_ppr;
+	bool by_position = gear->source == GEAR_SOURCE_POSITION &&
+	                   Encoder_IsEnabled(master->_id) && Encoder_IsEnabled(motor->_id);
+	uint16_t source = by_position ? GEAR_SOURCE_POSITION : GEAR_SOURCE_SPEED;
+	int32_t velocity, error;
+	int64_t correction;
+
+	// Vao khop (hoac doi nguon): lay goc tai vi tri hien tai, offset sau do dich pha
+	if (source != motor->_gearSource) {
+		motor->_gearMasterOrigin = master->_position;
+		motor->_gearSlaveOrigin = (int32_t)((uint32_t)motor->_position - (uint32_t)offset);
+		motor->_gearSource = source;
+	}
+
+	// Motor 1 do o tick truoc (Motor2_Task uu tien cao hon): tre 1 ms, khong qua bus
+	velocity = (int32_t)(((int64_t)master->_currentSpeed * num) / den);
+	if (by_position) {
+		int32_t travel = (int32_t)((uint32_t)master->_position - (uint32_t)motor->_gearMasterOrigin);
+		int32_t geared = (int32_t)(((int64_t)travel * num) / den);
+
+		motor->_positionRef = (int32_t)((uint32_t)motor->_gearSlaveOrigin + (uint32_t)offset +
+		                                (uint32_t)geared);
+		error = (int32_t)((uint32_t)motor->_positionRef - (uint32_t)motor->_position);
+		velocity += FP_Mul(error, motor->_posKp, 16);
+		// Kc x100 [1/s] * sai so [xung] -> RPM Motor 2
+		correction = (counts_per_rev != 0U) ?
+		             ((int64_t)error * gear->coupling_kc * 60) / ((int64_t)GAIN_SCALE * counts_per_rev) : 0;
+	} else {
+		error = velocity - motor->_currentSpeed;
+		correction = ((int64_t)error * gear->coupling_kc) / GAIN_SCALE;
+	}
+
+	motor->_speedRef = FP_Saturate(velocity, -INT16_MAX, INT16_MAX);
+	motor->_accelRef = (int32_t)(((int64_t)master->_accelRef * num) / den);
+	gear->sync_error = FP_Sat16(error);
+
+	// Motor 2 tre -> Motor 1 giam toc tuong ung (quy ve don vi Motor 1 qua ti so)
+	driver.gear_correction = (num != 0) ? FP_Sat32((-correction * den) / num) : 0;
+
+	_applyGainSchedule(motor);
+	motor->_currentRef = PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+	                                  _feedForward(motor));
+}
+
+void _runDiffDriveMode(MotorControl_t *motor) {
+	tDriveRegisters *drive = &g_modbus_data.drive;
+	DiffDrive_Params_t params = {
+		.wheel_base_mm = drive->wheel_base_mm,
+		.wheel_radius = drive->wheel_radius,
+		.max_wheel_rpm = drive->max_wheel_rpm,
+		.accel = drive->accel,
+		.alpha = drive->alpha,
+	};
+	DiffDrive_Wheel_t wheels[MOTOR_COUNT];
+	int32_t sign = motor->_direction ? -1 : 1;
+	int32_t v, w;
+
+	// Mx_Direction = chieu lap banh: tien cua robot luon la toc do duong
+	for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+		const MotorControl_t *wheel = MOTOR_CONTROL(i);
+		int32_t polarity = wheel->_direction ? -1 : 1;
+
+		wheels[i].rpm = polarity * wheel->_currentSpeed;
+		wheels[i].position = (int32_t)((uint32_t)polarity * (uint32_t)wheel->_position);
+		wheels[i].counts_per_rev = Encoder_IsEnabled(i) ? 4U * wheel->_encoderPpr : 0U;
+	}
+
+	// Cap v/w doc nguyen khoi (FC16 ghi trong ISR Modbus)
+	uint32_t primask = _enterCritical();
+	v = drive->v_cmd;
+	w = drive->w_cmd;
+	_exitCritical(primask);
+	v = _applyProximity(motor, v);
+
+	DiffDrive_Update(osKernelGetTickCount(), &params, v, w, wheels, CONFIG_CONTROL_LOOP_HZ);
+	motor->_speedRef = sign * DiffDrive_GetWheelRpm(motor->_id);
+	motor->_accelRef = 0;
+
+	_applyGainSchedule(motor);
+	motor->_output = (int16_t)PID_UpdateFF(&motor->_speedPid, motor->_speedRef, motor->_currentSpeed,
+	                                       _feedForward(motor));
+	PWM_SetDuty(motor->_id, motor->_output);
+}
+
+void _runCurrentLoop(MotorControl_t *motor) {
+	motor->_current = _getMotorCurrent(motor);
+	MotorIdent_FastSample(motor->_id, motor->_current);
+	Thermal_Update(motor->_id, motor->_current);
+
+	// Uoc luong back-EMF chi dung khi cau H dang dan (biet dien ap dau cuc)
+	if (motor->_enabled) {
+		BackEMF_Update(motor->_id, motor->_output, motor->_current);
+	} else {
+		BackEMF_Reset(motor->_id);
+	}
+
+	if (!motor->_enabled || motor->_proxHeld || !_hasCurrentLoop(motor->_mode)) {
+		return;
+	}
+	motor->_output = (int16_t)PID_Update(&motor->_currentPid, motor->_currentRef, motor->_current);
+	PWM_SetDuty(motor->_id, motor->_output);
+}
+
+// Gioi han momen: mo hinh I2t ha dong cho phep truoc khi motor / cau H dat nhiet
+// do dinh muc, sau ket (REDUCE) chi con reduce_pct. Mode co vong dong: gioi han
+// dong dat; mode duty: tran duty. Tra ve true khi mo hinh nhiet dang giam dong
+static bool _applyTorqueLimit(MotorControl_t *motor) {
+	tThermalRegisters *thermal = motor->_thermal;
+	Thermal_Params_t params = {
+		.motor_rated_ma = thermal->motor_rated_ma,
+		.motor_tau_s = thermal->motor_tau_s,
+		.horizon_ms = thermal->horizon_ms,
+	};
+	uint32_t scale = motor->_stallReduced ? motor->_stall->reduce_pct : 100U;
+	int32_t allowed, limit, ceiling, current, duty;
+
+	Thermal_Configure(motor->_id, &params, CurrentSense_GetLoopHz());
+	allowed = Thermal_GetAllowedCurrent(motor->_id);
+	motor->_thermalLimit = (uint16_t)allowed;
+
+	if (_hasCurrentLoop(motor->_mode)) {
+		limit = (motor->_ctrl->current_limit_ma > INT16_MAX) ? INT16_MAX : motor->_ctrl->current_limit_ma;
+		limit = (int32_t)(((uint32_t)limit * scale) / 100U);
+		motor->_dutyLimit = motor->_maxDuty;
+		if (allowed >= limit) {
+			if (motor->_speedPid.out_max != limit) {
+				PID_SetLimits(&motor->_speedPid, -limit, limit);
+			}
+			return false;
+		}
+		if (motor->_speedPid.out_max != allowed) {
+			PID_SetLimits(&motor->_speedPid, -allowed, allowed);
+		}
+		return true;
+	}
+
+	// Khong co vong dong: dong vuot muc -> ha tran ti le theo dong do duoc,
+	// duoi muc -> noi lai tu tu (~256 tick tu 0 len max)
+	ceiling = (int32_t)(((uint32_t)motor->_maxDuty * scale) / 100U);
+	if (ceiling > motor->_maxDuty) {
+		ceiling = motor->_maxDuty;
+	}
+	current = (motor->_current < 0) ? -motor->_current : motor->_current;
+	if (motor->_dutyLimit > ceiling) {
+		motor->_dutyLimit = (int16_t)ceiling;
+	}
+	if (current > allowed) {
+		duty = (motor->_output < 0) ? -motor->_output : motor->_output;
+		duty = (int32_t)(((int64_t)duty * allowed) / current);
+		if (duty < motor->_dutyLimit) {
+			motor->_dutyLimit = (int16_t)duty;
+		}
+	} else if (motor->_dutyLimit < ceiling) {
+		duty = motor->_dutyLimit + (motor->_maxDuty >> 8) + 1;
+		motor->_dutyLimit = (int16_t)((duty > ceiling) ? ceiling : duty);
+	}
+	if ((motor->_mode == MOTOR_MODE_PID || motor->_mode == MOTOR_MODE_DIFF_DRIVE) &&
+	    motor->_speedPid.out_max != motor->_dutyLimit) {
+		PID_SetLimits(&motor->_speedPid, -motor->_dutyLimit, motor->_dutyLimit);
+	}
+	return motor->_dutyLimit < ceiling;
+}
+
+// Phat hien ket rotor (dong lon + toc do thap + duty lon) va phan ung theo
+// REG_Mx_STALL_REACTION. Moi lan ket ghi MOTOR_ERR_STALL vao REG_Mx_ERROR_CODE
+static void _updateStall(MotorControl_t *motor) {
+	tMotorRegisters *regs = motor->_regs;
+	tStallRegisters *stall = motor->_stall;
+	Stall_Params_t params;
+
+	_getStallParams(motor, &params);
+
+	// Master da reset loi (REG_RESET_ERROR_COMMAND): bo ham, bo giam momen
+	if (regs->error == MOTOR_ERR_NONE && Stall_GetState(motor->_id) != STALL_STATE_OK) {
+		Stall_Reset(motor->_id);
+	}
+	if (regs->error != MOTOR_ERR_STALL) {
+		motor->_stallReduced = false;
+		if (motor->_braking) {
+			motor->_braking = false;
+			if (!motor->_enabled) {
+				PWM_SetDuty(motor->_id, 0);
+			}
+		}
+	}
+
+	// Den han thu lai: xoa STALL (tick sau _updateMotor bat lai motor). OCP trong
+	// luc cho giu nguyen loi, motor o FAULT den Reset_Error_Command
+	if (Stall_RetryDue(motor->_id, &regs->error, Protection_IsTripped())) {
+		return;
+	}
+	if (stall->reaction == STALL_REACTION_OFF || !motor->_enabled || motor->_stallReduced ||
+	    !Stall_Check(motor->_id, &params, motor->_current, motor->_currentSpeed, motor->_output) ||
+	    !Stall_Latch(motor->_id, &regs->error)) {
+		return;
+	}
+
+	switch (stall->reaction) {
+		case STALL_REACTION_BRAKE:
+			_setDisableMotor(motor);
+			PWM_Brake(motor->_id, PWM_DUTY_MAX);
+			motor->_braking = true;
+			break;
+		case STALL_REACTION_REDUCE:
+			motor->_stallReduced = true;    // van chay, _applyTorqueLimit ha gioi han
+			break;
+		case STALL_REACTION_RETRY:
+			_setDisableMotor(motor);
+			Stall_StartBackoff(motor->_id, &params);
+			if (Stall_GetState(motor->_id) == STALL_STATE_BACKOFF) {
+				_dispatch(motor, MOTOR_EVENT_BACKOFF);
+			}
+			break;
+		default:
+			_setDisableMotor(motor);        // COAST: cau H ho
+			break;
+	}
+}
+
+// Cam bien khoang cach (chung cho 2 motor, goi tu Motor 1): doc nguon, tinh he so
+// toc do, xuat REG_PROX_x
+static void _updateProximity(void) {
+	tProximityRegisters *prox = &g_modbus_data.proximity;
+	Proximity_Params_t params = {
+		.safe_cm = prox->safe_cm,
+		.slow_cm = prox->slow_cm,
+		.creep_pct = prox->creep_pct,
+		.timeout_ms = prox->timeout_ms,
+	};
+	uint16_t external = prox->distance_cm;
+	uint16_t status = 0;
+	int32_t scale;
+
+	// Cong tac vat can: tich cuc = vat nam trong khoang an toan
+	if (prox->source == PROXIMITY_SOURCE_PIN) {
+		external = _readInputPin(prox->pin, prox->active_low != 0U) ? 0U : PROXIMITY_DISTANCE_FAR;
+	}
+	Proximity_Update(osKernelGetTickCount(), prox->source, &params, external);
+	scale = Proximity_GetScale();
+
+	if (prox->source != PROXIMITY_SOURCE_OFF) {
+		if (Proximity_IsLost()) {
+			status |= PROXIMITY_STATUS_LOST;
+		}
+		if (scale == 0) {
+			status |= PROXIMITY_STATUS_STOP;
+		} else if (scale < PROXIMITY_SCALE_FULL) {
+			status |= PROXIMITY_STATUS_SLOW;
+		}
+	}
+	if (prox->source != PROXIMITY_SOURCE_REGISTER) {
+		prox->distance_cm = Proximity_GetDistance();
+	}
+	prox->scale_pct = (uint16_t)((scale * 100 + PROXIMITY_SCALE_FULL / 2) >> 15);
+	prox->status = status;
+	prox->frames = Proximity_GetFrames();
+}
+
+// Vat can trong _safeDistance (hoac mat cam bien) theo chieu dang chay: giu output = 0,
+// motor van _enabled. Het vat can: chay lai tu trang thai hien tai nhu khi vua bat.
+// POSITION huy lenh di chuyen dang chay
+static bool _proximityHold(MotorControl_t *motor) {
+	bool hold = _proximityGuarded(motor) &&
+	            (Proximity_IsLost() || motor->_distanceSensorValue <= motor->_safeDistance);
+
+	if (!hold) {
+		if (motor->_proxHeld && _dispatch(motor, MOTOR_EVENT_RELEASE)) {
+			_startOutput(motor);
+		}
+		return false;
+	}
+	if (!motor->_proxHeld) {
+		_dispatch(motor, MOTOR_EVENT_HOLD);
+		AutoTune_Abort(motor->_id);
+		MotionQueue_Flush(motor->_id);
+		motor->_queueStreaming = false;
+		motor->_queueStarved = false;
+		if (motor->_mode == MOTOR_MODE_ONOFF) {
+			OnOff_Stop(motor->_id, osKernelGetTickCount());  // bat lai co soft-start
+		}
+	}
+	uint32_t primask = _enterCritical();
+	motor->_proxHeld = true;
+	motor->_currentRef = 0;
+	motor->_output = 0;
+	PWM_SetDuty(motor->_id, 0);
+	_exitCritical(primask);
+	return true;
+}
+
+// Loi chot / xoa khi motor dang tat: FAULT <-> DISABLED. RECOVERING den han thu
+// lai (loi da xoa) di thang sang RUNNING qua ENABLE; bi huy (OCP trong luc cho,
+// loi van chot) quay ve FAULT
+static void _syncFaultState(MotorControl_t *motor, bool enable) {
+	MotorState_t state = MotorState_Get(motor->_id);
+
+	if (_faultLatched(motor)) {
+		if (state == MOTOR_STATE_DISABLED ||
+		    (state == MOTOR_STATE_RECOVERING && Stall_GetState(motor->_id) != STALL_STATE_BACKOFF)) {
+			_dispatch(motor, MOTOR_EVENT_FAULT);
+		}
+	} else if (state == MOTOR_STATE_FAULT || (state == MOTOR_STATE_RECOVERING && !enable)) {
+		_dispatch(motor, MOTOR_EVENT_RESET);
+	}
+}
+
+static void _publishStatus(MotorControl_t *motor, int status) {
+	tMotorControlRegisters *ctrl = motor->_ctrl;
+	tThermalRegisters *thermal = motor->_thermal;
+
+	if (motor->_regs->error != MOTOR_ERR_NONE) {
+		status |= MOTOR_STATUS_FAULT;
+	}
+	motor->_status = status;
+	motor->_regs->status = (uint16_t)status;
+	ctrl->current_ref_ma = FP_Sat16(motor->_currentRef);
+	ctrl->tune_state = (uint16_t)AutoTune_GetState(motor->_id);
+	ctrl->tune_progress = AutoTune_GetProgress(motor->_id);
+	ctrl->ident_state = (uint16_t)MotorIdent_GetState(motor->_id);
+	motor->_motion->queue_depth = MotionQueue_GetDepth(motor->_id);
+	motor->_motion->queue_underflow = MotionQueue_GetUnderflows(motor->_id);
+	motor->_motion->queue_index = MotionQueue_GetIndex(motor->_id);
+	motor->_motion->queue_overflow = MotionQueue_GetOverflows(motor->_id);
+	motor->_stall->count = Stall_GetCount(motor->_id);
+	motor->_stall->retries = Stall_GetRetries(motor->_id);
+	motor->_stall->state = (uint16_t)Stall_GetState(motor->_id);
+	motor->_onoff->state = (uint16_t)OnOff_GetState(motor->_id);
+	if (motor->_id == 0) {
+		g_modbus_data.msm.m1_state = (uint16_t)MotorState_Get(0);
+	} else {
+		g_modbus_data.msm.m2_state = (uint16_t)MotorState_Get(1);
+	}
+	thermal->motor_pct = Thermal_GetMotorPercent(motor->_id);
+	thermal->bridge_pct = Thermal_GetBridgePercent(motor->_id);
+	thermal->limit_ma = motor->_thermalLimit;
+	motor->_regs->thermal_pct = (thermal->motor_pct > thermal->bridge_pct) ?
+	                            thermal->motor_pct : thermal->bridge_pct;
+}
+
+void _updateMotor(MotorControl_t *motor) {
+	tMotorRegisters *regs = motor->_regs;
+	bool enable;
+	int status = 0;
+
+	_setRuningMode(regs, motor);
+
+	motor->_direction = (regs->direction != 0U);
+	motor->_targetSpeed = motor->_direction ? -(int32_t)regs->cmd_speed : regs->cmd_speed;
+	_updateFeedback(motor);
+	if (motor->_id == 0) {
+		_updateProximity();
+	}
+	motor->_distanceSensorValue = Proximity_GetDistance();
+	motor->_safeDistance = g_modbus_data.proximity.safe_cm;
+
+	// Nhan dang thong so chiem output, cac mode cho den khi xong
+	if (_runIdentification(motor)) {
+		status |= MOTOR_STATUS_IDENT;
+		_publishStatus(motor, status);
+		return;
+	}
+
+	// REDUCE: loi ket duoc ghi nhan nhung motor chay tiep voi momen giam
+	enable = _isModeEnabled(motor) &&
+	         (regs->error == MOTOR_ERR_NONE || (regs->error == MOTOR_ERR_STALL && motor->_stallReduced));
+	_syncFaultState(motor, enable);
+	// Bat lai giua luc dung co kiem soat: co hieu luc khi da dung han
+	if (enable && !motor->_enabled) {
+		_setEnableMotor(motor);
+	} else if (!enable && motor->_enabled && !motor->_stopping) {
+		if (regs->error == MOTOR_ERR_NONE && motor->_ctrl->stop_mode == STOP_MODE_DECEL) {
+			_startControlledStop(motor);
+		} else {
+			_setDisableMotor(motor);
+		}
+	} else if (motor->_stopping && regs->error != MOTOR_ERR_NONE) {
+		_setDisableMotor(motor);
+	}
+	_updateStall(motor);
+	if (Stall_GetState(motor->_id) != STALL_STATE_OK || motor->_stallReduced || motor->_braking) {
+		status |= MOTOR_STATUS_STALL;
+	}
+
+	_handleMoveCommand(motor);
+	_handleQueuePush(motor);
+	if (_applyTorqueLimit(motor) && motor->_enabled) {
+		status |= MOTOR_STATUS_DERATING;
+	}
+
+	if (motor->_stopping) {
+		status |= MOTOR_STATUS_ENABLED | MOTOR_STATUS_STOPPING;
+		if (_runControlledStop(motor)) {
+			_stopOutput(motor, MOTOR_EVENT_STOPPED);
+		}
+	} else if (motor->_enabled && _proximityHold(motor)) {
+		status |= MOTOR_STATUS_ENABLED | MOTOR_STATUS_PROX_STOP;
+	} else if (motor->_enabled && _runAutoTune(motor)) {
+		status |= MOTOR_STATUS_ENABLED | MOTOR_STATUS_TUNING;
+	} else if (motor->_enabled) {
+		switch (motor->_mode) {
+			case MOTOR_MODE_ONOFF:   _runOnOffMode(motor); break;
+			case MOTOR_MODE_LINEAR:  _runLinearMode(motor); break;
+			case MOTOR_MODE_PID:     _runPIDMode(motor); break;
+			case MOTOR_MODE_CASCADE: _runCascadeMode(motor); break;
+			case MOTOR_MODE_POSITION: _runPositionMode(motor); break;
+			case MOTOR_MODE_GEARED:   _runGearedMode(motor); break;
+			case MOTOR_MODE_DIFF_DRIVE: _runDiffDriveMode(motor); break;
+		}
+		status |= MOTOR_STATUS_ENABLED;
+		if (motor->_mode != MOTOR_MODE_POSITION && motor->_mode != MOTOR_MODE_GEARED &&
+		    _proximityScale(motor) < PROXIMITY_SCALE_FULL) {
+			status |= MOTOR_STATUS_PROX_SLOW;
+		}
+		if (motor->_mode == MOTOR_MODE_POSITION && MoveProfile_IsDone(&motor->_profile)) {
+			int32_t error = (int32_t)((uint32_t)MoveProfile_GetTarget(&motor->_profile) -
+			                          (uint32_t)motor->_position);
+			status |= MOTOR_STATUS_MOVE_DONE;
+			if (error <= (int32_t)motor->_motion->in_pos_window &&
+			    error >= -(int32_t)motor->_motion->in_pos_window) {
+				status |= MOTOR_STATUS_IN_POSITION;
+			}
+		}
+		if (_hasCurrentLoop(motor->_mode) &&
+		    (motor->_currentRef >= motor->_speedPid.out_max ||
+		     motor->_currentRef <= motor->_speedPid.out_min)) {
+			status |= MOTOR_STATUS_CURRENT_LIMIT;
+		}
+	}
+	_publishStatus(motor, status);
+	if (motor->_id == 0) {
+		_publishDiffDrive();
+		_publishStateMachine();
+	}
+}
+
+// Goi tu ISR DMA cua CurrentSense moi tick vong nhanh (CONFIG_CURRENT_LOOP_HZ)
+void CurrentSense_SampleCallback(void) {
+	_runCurrentLoop(&driver.motor1);
+	_runCurrentLoop(&driver.motor2);
+	PWM_Dither();
+}
@@ -0,0 +1,145 @@
+/*
+ * MotorIdent.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "MotorIdent.h"
+#include "main.h"
+#include "Config.h"
+#include "CurrentSense.h"
+#include "FixedPoint.h"
+
+#define IDENT_NO_OWNER          0xFFU
+
+// Buffer dung chung cho ca hai motor (~3.3 KB)
+static MotorIdent_Sample_t slow_buffer[CONFIG_IDENT_SLOW_SAMPLES];
+static int16_t fast_buffer[CONFIG_IDENT_FAST_SAMPLES];
+static volatile uint16_t fast_count;
+static volatile bool fast_armed;
+
+static uint8_t  owner = IDENT_NO_OWNER;
+static MotorIdent_State_t states[MOTOR_COUNT];
+static MotorIdent_Result_t results[MOTOR_COUNT];
+
+static int16_t  step_duty;
+static int16_t  prev_duty;              // duty cua chu ky truoc (sinh ra dong/toc do dang do)
+static uint16_t vbus_mv;
+static bool     has_speed;
+static uint32_t elapsed_ms;
+static uint16_t slow_count;
+static uint32_t fast_hz;
+
+static bool MotorIdent_Solve(MotorIdent_Result_t *res) {
+    MotorIdent_Capture_t cap = {
+        .fast = fast_buffer,
+        .fast_count = fast_count,
+        .fast_hz = fast_hz,
+        .slow = slow_buffer,
+        .slow_count = slow_count,
+        .slow_period_ms = CONFIG_IDENT_DECIMATION,
+        .step_duty = step_duty,
+        .vbus_mv = vbus_mv,
+        .has_speed = has_speed,
+    };
+    return MotorIdent_Fit(&cap, res);
+}
+
+/* ---------------------------------------------------------------------------
+ * Chuoi thu
+ * ---------------------------------------------------------------------------
+ */
+bool MotorIdent_Start(uint8_t motor, int16_t duty, uint16_t vbus, bool speed_feedback) {
+    if (motor >= MOTOR_COUNT || duty <= 0 || vbus == 0U) {
+        return false;
+    }
+    // Hai task motor khac uu tien cung gianh buffer: kiem tra va chiem khong bi chen
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool free = (owner == IDENT_NO_OWNER);
+    if (free) {
+        owner = motor;
+    }
+    __set_PRIMASK(primask);
+    if (!free) {
+        return false;
+    }
+    step_duty = duty;
+    vbus_mv = vbus;
+    has_speed = speed_feedback;
+    elapsed_ms = 0;
+    prev_duty = 0;
+    slow_count = 0;
+    fast_count = 0;
+    fast_hz = CurrentSense_GetLoopHz();
+    fast_armed = true;                  // mau nhanh bat dau tu tick ISR ke tiep
+    states[motor] = IDENT_STEP;
+    return true;
+}
+
+void MotorIdent_Abort(uint8_t motor) {
+    if (motor < MOTOR_COUNT && owner == motor) {
+        fast_armed = false;
+        owner = IDENT_NO_OWNER;
+        states[motor] = IDENT_IDLE;
+    }
+}
+
+int16_t MotorIdent_Step(uint8_t motor, int32_t current_ma, int32_t speed_rpm) {
+    if (motor >= MOTOR_COUNT || owner != motor) {
+        return 0;
+    }
+    int32_t duty;
+
+    // Step -> doc len 2x -> doc xuong ve step -> dung
+    if (elapsed_ms < CONFIG_IDENT_STEP_MS) {
+        duty = step_duty;
+        states[motor] = IDENT_STEP;
+    } else if (elapsed_ms < CONFIG_IDENT_STEP_MS + CONFIG_IDENT_RAMP_MS) {
+        duty = step_duty + (int32_t)(((int64_t)step_duty * (elapsed_ms - CONFIG_IDENT_STEP_MS)) / CONFIG_IDENT_RAMP_MS);
+        states[motor] = IDENT_RAMP;
+    } else if (elapsed_ms < CONFIG_IDENT_STEP_MS + 2U * CONFIG_IDENT_RAMP_MS) {
+        duty = 2 * step_duty - (int32_t)(((int64_t)step_duty *
+               (elapsed_ms - CONFIG_IDENT_STEP_MS - CONFIG_IDENT_RAMP_MS)) / CONFIG_IDENT_RAMP_MS);
+    } else {
+        fast_armed = false;
+        owner = IDENT_NO_OWNER;
+        states[motor] = MotorIdent_Solve(&results[motor]) ? IDENT_DONE : IDENT_FAILED;
+        return 0;
+    }
+    duty = FP_Saturate(duty, 0, INT16_MAX);
+
+    if ((elapsed_ms % CONFIG_IDENT_DECIMATION) == 0U && slow_count < CONFIG_IDENT_SLOW_SAMPLES) {
+        MotorIdent_Sample_t *s = &slow_buffer[slow_count++];
+        s->duty = prev_duty;
+        s->current_ma = FP_Sat16(current_ma);
+        s->speed_rpm = FP_Sat16(speed_rpm);
+    }
+    prev_duty = (int16_t)duty;
+    elapsed_ms++;
+    return (int16_t)duty;
+}
+
+void MotorIdent_FastSample(uint8_t motor, int32_t current_ma) {
+    if (!fast_armed || motor != owner) {
+        return;
+    }
+    if (fast_count < CONFIG_IDENT_FAST_SAMPLES) {
+        fast_buffer[fast_count++] = FP_Sat16(current_ma);
+    } else {
+        fast_armed = false;
+    }
+}
+
+MotorIdent_State_t MotorIdent_GetState(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? states[motor] : IDENT_IDLE;
+}
+
+bool MotorIdent_GetResult(uint8_t motor, MotorIdent_Result_t *out) {
+    if (motor >= MOTOR_COUNT || states[motor] != IDENT_DONE) {
+        return false;
+    }
+    *out = results[motor];
+    return true;
+}
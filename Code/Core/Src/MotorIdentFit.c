@@ -0,0 +1,186 @@
+/*
+ * MotorIdentFit.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "MotorIdentFit.h"
+
+#define IDENT_MAX_PARAMS        4
+
+/* ---------------------------------------------------------------------------
+ * Least squares: A^T A x = A^T y, khu Gauss co chon truc (n <= 4)
+ * ---------------------------------------------------------------------------
+ */
+typedef struct {
+    uint8_t n;
+    float ata[IDENT_MAX_PARAMS][IDENT_MAX_PARAMS];
+    float aty[IDENT_MAX_PARAMS];
+} MotorIdent_Lsq_t;
+
+static void MotorIdent_LsqInit(MotorIdent_Lsq_t *lsq, uint8_t n) {
+    lsq->n = n;
+    for (uint8_t i = 0; i < IDENT_MAX_PARAMS; i++) {
+        lsq->aty[i] = 0.0f;
+        for (uint8_t j = 0; j < IDENT_MAX_PARAMS; j++) {
+            lsq->ata[i][j] = 0.0f;
+        }
+    }
+}
+
+static void MotorIdent_LsqAdd(MotorIdent_Lsq_t *lsq, const float *row, float y) {
+    for (uint8_t i = 0; i < lsq->n; i++) {
+        lsq->aty[i] += row[i] * y;
+        for (uint8_t j = 0; j < lsq->n; j++) {
+            lsq->ata[i][j] += row[i] * row[j];
+        }
+    }
+}
+
+static bool MotorIdent_LsqSolve(MotorIdent_Lsq_t *lsq, float *x) {
+    uint8_t n = lsq->n;
+
+    for (uint8_t col = 0; col < n; col++) {
+        uint8_t pivot = col;
+        for (uint8_t r = col + 1U; r < n; r++) {
+            float a = lsq->ata[r][col] < 0.0f ? -lsq->ata[r][col] : lsq->ata[r][col];
+            float b = lsq->ata[pivot][col] < 0.0f ? -lsq->ata[pivot][col] : lsq->ata[pivot][col];
+            if (a > b) {
+                pivot = r;
+            }
+        }
+        if (lsq->ata[pivot][col] == 0.0f) {
+            return false;                       // du lieu khong du kich thich
+        }
+        if (pivot != col) {
+            for (uint8_t k = 0; k < n; k++) {
+                float t = lsq->ata[col][k];
+                lsq->ata[col][k] = lsq->ata[pivot][k];
+                lsq->ata[pivot][k] = t;
+            }
+            float t = lsq->aty[col];
+            lsq->aty[col] = lsq->aty[pivot];
+            lsq->aty[pivot] = t;
+        }
+        for (uint8_t r = col + 1U; r < n; r++) {
+            float f = lsq->ata[r][col] / lsq->ata[col][col];
+            for (uint8_t k = col; k < n; k++) {
+                lsq->ata[r][k] -= f * lsq->ata[col][k];
+            }
+            lsq->aty[r] -= f * lsq->aty[col];
+        }
+    }
+    for (int8_t r = (int8_t)n - 1; r >= 0; r--) {
+        float sum = lsq->aty[r];
+        for (uint8_t k = (uint8_t)r + 1U; k < n; k++) {
+            sum -= lsq->ata[r][k] * x[k];
+        }
+        x[r] = sum / lsq->ata[r][r];
+    }
+    return true;
+}
+
+static uint16_t MotorIdent_ToReg(float value) {
+    if (value <= 0.0f) {
+        return 0;
+    }
+    if (value >= 65535.0f) {
+        return UINT16_MAX;
+    }
+    return (uint16_t)(value + 0.5f);
+}
+
+static float MotorIdent_Volts(const MotorIdent_Capture_t *cap, int32_t duty) {
+    return (float)duty * (float)cap->vbus_mv / 32768.0f;   // mV
+}
+
+/* ---------------------------------------------------------------------------
+ * Fit
+ * ---------------------------------------------------------------------------
+ */
+bool MotorIdent_Fit(const MotorIdent_Capture_t *cap, MotorIdent_Result_t *res) {
+    MotorIdent_Lsq_t lsq;
+    float x[IDENT_MAX_PARAMS];
+    float ts = (float)cap->slow_period_ms / 1000.0f;
+    float r_ohm, l_h;
+
+    if (cap->fast_hz == 0U || cap->vbus_mv == 0U) {
+        return false;
+    }
+
+    // A) Dien: V = R*I + L*dI/dt + Ke*w tren mau nhanh dau buoc. Roto da bat
+    // dau quay trong cua so nay: w ~ (Q - Fc*t) / J voi Q = tich phan dong, nen
+    // lay tich phan hai ve tu mau 1 (mau 0 co the truoc buoc) va them hai cot
+    // hap thu suc phan dien: V*t = R*Q + L*(I - I1) + a*tich phan Q + b*t^2/2
+    float v_step = MotorIdent_Volts(cap, cap->step_duty);
+    float dt_fast = 1.0f / (float)cap->fast_hz;
+    float q = 0.0f, q_int = 0.0f;
+    MotorIdent_LsqInit(&lsq, 4);
+    for (uint16_t k = 2; k < cap->fast_count; k++) {
+        float t = (float)(k - 1U) * dt_fast;
+        float q_prev = q;
+        q += 0.5f * (float)(cap->fast[k] + cap->fast[k - 1]) * dt_fast;    // hinh thang
+        q_int += 0.5f * (q + q_prev) * dt_fast;
+        float row[4] = { q, (float)(cap->fast[k] - cap->fast[1]), q_int, 0.5f * t * t };
+        MotorIdent_LsqAdd(&lsq, row, v_step * t);
+    }
+    if (!MotorIdent_LsqSolve(&lsq, x) || x[0] <= 0.0f) {
+        return false;
+    }
+    r_ohm = x[0];                                   // mV / mA
+    l_h = (x[1] > 0.0f) ? x[1] : 0.0f;              // mV / (mA/s)
+    res->r_mohm = MotorIdent_ToReg(r_ohm * 1000.0f);
+    res->l_uh = MotorIdent_ToReg(l_h * 1000000.0f);
+
+    if (!cap->has_speed) {
+        res->ke_uv_per_rpm = 0;
+        res->j_ua_s_per_rpm = 0;
+        res->fv_ua_per_rpm = 0;
+        res->fc_ma = 0;
+        return true;
+    }
+
+    // B) Ke: V - R*I = Ke*w (mau cham, bo qua L*dI/dt)
+    MotorIdent_LsqInit(&lsq, 1);
+    for (uint16_t k = 0; k < cap->slow_count; k++) {
+        const MotorIdent_Sample_t *s = &cap->slow[k];
+        if (s->duty == 0 || s->speed_rpm == 0) {
+            continue;
+        }
+        float row[1] = { (float)s->speed_rpm };
+        MotorIdent_LsqAdd(&lsq, row, MotorIdent_Volts(cap, s->duty) - r_ohm * (float)s->current_ma);
+    }
+    if (!MotorIdent_LsqSolve(&lsq, x) || x[0] <= 0.0f) {
+        return false;
+    }
+    res->ke_uv_per_rpm = MotorIdent_ToReg(x[0] * 1000.0f);
+
+    // C) Co: I = J*dw/dt + Fv*w + Fc. Lay tich phan tu mau k0 (roto da quay)
+    // thay vi dao ham toc do da luong tu hoa (nhieu dw/dt lam lech J, Fv):
+    // tich phan I = J*(w - w0) + Fv*tich phan w + Fc*t, chi khi w > 0
+    uint16_t k0 = 0;
+    while (k0 < cap->slow_count && (cap->slow[k0].duty == 0 || cap->slow[k0].speed_rpm <= 0)) {
+        k0++;
+    }
+    float i_int = 0.0f, w_int = 0.0f;
+    MotorIdent_LsqInit(&lsq, 3);
+    for (uint16_t k = k0 + 1U; k < cap->slow_count; k++) {
+        const MotorIdent_Sample_t *s = &cap->slow[k];
+        const MotorIdent_Sample_t *p = &cap->slow[k - 1U];
+        if (s->duty == 0 || s->speed_rpm <= 0) {
+            break;
+        }
+        i_int += 0.5f * (float)(s->current_ma + p->current_ma) * ts;
+        w_int += 0.5f * (float)(s->speed_rpm + p->speed_rpm) * ts;
+        float row[3] = { (float)(s->speed_rpm - cap->slow[k0].speed_rpm), w_int, (float)(k - k0) * ts };
+        MotorIdent_LsqAdd(&lsq, row, i_int);
+    }
+    if (!MotorIdent_LsqSolve(&lsq, x)) {
+        return false;
+    }
+    res->j_ua_s_per_rpm = MotorIdent_ToReg(x[0] * 1000.0f);
+    res->fv_ua_per_rpm = MotorIdent_ToReg(x[1] * 1000.0f);
+    res->fc_ma = MotorIdent_ToReg(x[2]);
+    return true;
+}
@@ -0,0 +1,119 @@
+/*
+ * MotorState.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "MotorState.h"
+#include "Config.h"
+#include "main.h"
+#include <string.h>
+
+// Ten ngan cho bang chuyen trang thai
+#define DIS     MOTOR_STATE_DISABLED
+#define RDY     MOTOR_STATE_READY
+#define RUN     MOTOR_STATE_RUNNING
+#define STP     MOTOR_STATE_STOPPING
+#define FLT     MOTOR_STATE_FAULT
+#define REC     MOTOR_STATE_RECOVERING
+#define ___     MOTOR_STATE_COUNT      // su kien khong hop le o trang thai nay
+
+// Trang thai dich [trang thai hien tai][su kien]
+static const uint8_t transitions[MOTOR_STATE_COUNT][MOTOR_EVENT_COUNT] = {
+    /*         ENABLE DISABLE STOP STOPPED FAULT BACKOFF RESET HOLD RELEASE MODE */
+    [DIS] = {  RUN,   ___,    ___, ___,    FLT,  ___,    ___,  ___, ___,    ___ },
+    [RDY] = {  ___,   DIS,    STP, ___,    FLT,  ___,    ___,  ___, RUN,    RDY },
+    [RUN] = {  ___,   DIS,    STP, ___,    FLT,  ___,    ___,  RDY, ___,    RUN },
+    [STP] = {  ___,   DIS,    ___, DIS,    FLT,  ___,    ___,  ___, ___,    ___ },
+    [FLT] = {  ___,   ___,    ___, ___,    ___,  REC,    DIS,  ___, ___,    ___ },
+    [REC] = {  RUN,   ___,    ___, ___,    FLT,  ___,    DIS,  ___, ___,    ___ },
+};
+
+#undef DIS
+#undef RDY
+#undef RUN
+#undef STP
+#undef FLT
+#undef REC
+#undef ___
+
+static MotorState_t states[MOTOR_COUNT];
+static MotorState_LogEntry_t log_entries[MOTOR_STATE_LOG_DEPTH];   // [0] = moi nhat
+static uint8_t log_count;
+static uint16_t transition_count;
+static uint16_t rejected_count;
+
+void MotorState_Init(void) {
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        states[i] = MOTOR_STATE_DISABLED;
+    }
+    MotorState_ClearLog();
+}
+
+MotorState_t MotorState_Next(uint8_t motor, MotorEvent_t event) {
+    if (motor >= MOTOR_COUNT || (uint32_t)event >= MOTOR_EVENT_COUNT) {
+        return MOTOR_STATE_COUNT;
+    }
+    return (MotorState_t)transitions[states[motor]][event];
+}
+
+bool MotorState_Dispatch(uint8_t motor, MotorEvent_t event, uint8_t mode, uint32_t now_ms) {
+    MotorState_t next = MotorState_Next(motor, event);
+    uint32_t primask;
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    if (next == MOTOR_STATE_COUNT) {
+        rejected_count++;
+        __set_PRIMASK(primask);
+        return false;
+    }
+    memmove(&log_entries[1], &log_entries[0], sizeof(log_entries) - sizeof(log_entries[0]));
+    log_entries[0].time_ms = now_ms;
+    log_entries[0].motor = motor;
+    log_entries[0].from = (uint8_t)states[motor];
+    log_entries[0].to = (uint8_t)next;
+    log_entries[0].mode = mode;
+    log_entries[0].event = (uint8_t)event;
+    if (log_count < MOTOR_STATE_LOG_DEPTH) {
+        log_count++;
+    }
+    transition_count++;
+    states[motor] = next;
+    __set_PRIMASK(primask);
+    return true;
+}
+
+MotorState_t MotorState_Get(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? states[motor] : MOTOR_STATE_DISABLED;
+}
+
+bool MotorState_GetLog(uint8_t index, MotorState_LogEntry_t *entry) {
+    uint32_t primask;
+
+    if (index >= log_count) {
+        return false;
+    }
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *entry = log_entries[index];
+    __set_PRIMASK(primask);
+    return true;
+}
+
+uint16_t MotorState_GetTransitions(void) {
+    return transition_count;
+}
+
+uint16_t MotorState_GetRejected(void) {
+    return rejected_count;
+}
+
+void MotorState_ClearLog(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    memset(log_entries, 0, sizeof(log_entries));
+    log_count = 0;
+    __set_PRIMASK(primask);
+}
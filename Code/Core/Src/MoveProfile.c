@@ -0,0 +1,151 @@
+/*
+ * MoveProfile.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "MoveProfile.h"
+
+#define Q24_ONE     (1LL << 24)
+
+// Quang duong phanh tu toc do speed voi gia toc accel (Q24), bao hoa thay vi tran
+static int64_t MoveProfile_StopDistance(int64_t speed, int64_t accel) {
+    int64_t ticks;
+
+    if (speed <= 0) {
+        return 0;
+    }
+    ticks = speed / accel + 1;
+    if (ticks > INT64_MAX / speed) {
+        return INT64_MAX;
+    }
+    return (speed * ticks) / 2;
+}
+
+static int64_t MoveProfile_ClampTarget(int64_t counts) {
+    if (counts > INT32_MAX) {
+        counts = INT32_MAX;
+    } else if (counts < INT32_MIN) {
+        counts = INT32_MIN;
+    }
+    return counts * Q24_ONE;
+}
+
+void MoveProfile_Reset(MoveProfile_t *profile, int32_t position) {
+    profile->pos_q24 = (int64_t)position * Q24_ONE;
+    profile->vel_q24 = 0;
+    profile->target_q24 = profile->pos_q24;
+    profile->accel_sign = 0;
+    profile->done = true;
+}
+
+void MoveProfile_Start(MoveProfile_t *profile, int32_t target, uint16_t vmax_rpm,
+                       uint16_t accel_rpm_s, uint32_t counts_per_rev, uint32_t loop_hz) {
+    if (vmax_rpm == 0U || counts_per_rev == 0U || loop_hz == 0U) {
+        return;
+    }
+
+    // RPM -> xung/tick, RPM/s -> xung/tick^2
+    profile->vmax_q24 = ((int64_t)vmax_rpm * counts_per_rev * Q24_ONE) / (60LL * loop_hz);
+    profile->accel_q24 = ((int64_t)accel_rpm_s * counts_per_rev * Q24_ONE) /
+                         (60LL * loop_hz * loop_hz);
+    if (profile->vmax_q24 <= 0) {
+        profile->vmax_q24 = 1;
+    }
+    if (accel_rpm_s == 0U || profile->accel_q24 <= 0 || profile->accel_q24 > profile->vmax_q24) {
+        profile->accel_q24 = profile->vmax_q24;
+    }
+    profile->counts_per_rev = counts_per_rev;
+    profile->loop_hz = loop_hz;
+    profile->accel_rpm_s = accel_rpm_s;
+    profile->target_q24 = MoveProfile_ClampTarget(target);
+    profile->done = (profile->target_q24 == profile->pos_q24 && profile->vel_q24 == 0);
+}
+
+void MoveProfile_Stop(MoveProfile_t *profile) {
+    int64_t v = profile->vel_q24;
+    int64_t d;
+
+    if (profile->done) {
+        return;
+    }
+    d = MoveProfile_StopDistance((v < 0) ? -v : v, profile->accel_q24) / Q24_ONE + 1;
+    profile->target_q24 = MoveProfile_ClampTarget(profile->pos_q24 / Q24_ONE + ((v < 0) ? -d : d));
+}
+
+int32_t MoveProfile_Update(MoveProfile_t *profile) {
+    int64_t rem = profile->target_q24 - profile->pos_q24;
+    int64_t a = profile->accel_q24;
+    int64_t dir = (rem >= 0) ? 1 : -1;
+    int64_t dist = rem * dir;
+    int64_t toward = profile->vel_q24 * dir;     // toc do huong ve target
+    int64_t next;
+
+    if (profile->done) {
+        profile->accel_sign = 0;
+        return MoveProfile_GetPosition(profile);
+    }
+
+    if (toward > 0 && dist <= MoveProfile_StopDistance(toward, a) + toward) {
+        next = toward - a;
+        if (next <= 0) {
+            // Phan con lai nho hon mot buoc gia toc: chot tai target
+            profile->pos_q24 = profile->target_q24;
+            profile->vel_q24 = 0;
+            profile->accel_sign = 0;
+            profile->done = true;
+            return MoveProfile_GetPosition(profile);
+        }
+    } else if (toward < profile->vmax_q24) {
+        next = toward + a;
+        if (next > profile->vmax_q24) {
+            next = profile->vmax_q24;
+        }
+    } else {
+        next = toward - a;                      // vmax vua bi giam
+        if (next < profile->vmax_q24) {
+            next = profile->vmax_q24;
+        }
+    }
+
+    profile->accel_sign = (int8_t)((next > toward) ? dir : ((next < toward) ? -dir : 0));
+    profile->vel_q24 = next * dir;
+    profile->pos_q24 += profile->vel_q24;
+
+    // Vuot qua target (buoc cuoi): chot lai
+    if ((profile->target_q24 - profile->pos_q24) * dir <= 0) {
+        profile->pos_q24 = profile->target_q24;
+        profile->vel_q24 = 0;
+        profile->done = true;
+    }
+    return MoveProfile_GetPosition(profile);
+}
+
+int32_t MoveProfile_GetPosition(const MoveProfile_t *profile) {
+    return (int32_t)((profile->pos_q24 + (Q24_ONE / 2)) >> 24);
+}
+
+int32_t MoveProfile_GetTarget(const MoveProfile_t *profile) {
+    return (int32_t)(profile->target_q24 >> 24);
+}
+
+int32_t MoveProfile_GetVelocity(const MoveProfile_t *profile) {
+    if (profile->counts_per_rev == 0U) {
+        return 0;
+    }
+    return (int32_t)((profile->vel_q24 * 60LL * profile->loop_hz / profile->counts_per_rev) >> 24);
+}
+
+int32_t MoveProfile_GetAccel(const MoveProfile_t *profile) {
+    return profile->accel_sign * (int32_t)profile->accel_rpm_s;
+}
+
+bool MoveProfile_IsDone(const MoveProfile_t *profile) {
+    return profile->done;
+}
+
+bool MoveProfile_IsDecelerating(const MoveProfile_t *profile) {
+    return profile->vel_q24 != 0 && profile->accel_sign != 0 &&
+           (profile->accel_sign > 0) != (profile->vel_q24 > 0);
+}
@@ -0,0 +1,91 @@
+/*
+ * OnOff.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "OnOff.h"
+#include "Config.h"
+#include "PWM.h"
+
+typedef struct {
+    OnOff_State_t state;
+    uint32_t switch_ms;         // thoi diem bat / tat gan nhat
+    bool switched;              // chua bat lan nao: khong cho min_off luc khoi dong
+} OnOff_t;
+
+static OnOff_t onoffs[MOTOR_COUNT];
+
+static bool OnOff_IsRunning(OnOff_State_t state) {
+    return state == ONOFF_STATE_SOFT_START || state == ONOFF_STATE_ON ||
+           state == ONOFF_STATE_HOLD_ON;
+}
+
+void OnOff_Stop(uint8_t motor, uint32_t now_ms) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    OnOff_t *s = &onoffs[motor];
+    if (OnOff_IsRunning(s->state)) {
+        s->switch_ms = now_ms;
+    }
+    s->state = ONOFF_STATE_OFF;
+}
+
+void OnOff_Resume(uint8_t motor, const OnOff_Params_t *params, int32_t duty, uint32_t now_ms) {
+    if (motor >= MOTOR_COUNT || duty <= 0) {
+        return;
+    }
+    OnOff_t *s = &onoffs[motor];
+    uint32_t on_pm = (params->on_duty_pm > 1000U) ? 1000U : params->on_duty_pm;
+    int32_t full = (int32_t)((on_pm * PWM_DUTY_MAX) / 1000U);
+    uint32_t elapsed = params->soft_start_ms;
+
+    if (duty < full) {
+        elapsed = (uint32_t)(((uint64_t)duty * params->soft_start_ms) / (uint32_t)full);
+    }
+    s->switch_ms = now_ms - elapsed;
+    s->switched = true;
+    s->state = (elapsed < params->soft_start_ms) ? ONOFF_STATE_SOFT_START : ONOFF_STATE_ON;
+}
+
+int32_t OnOff_Update(uint8_t motor, const OnOff_Params_t *params, bool demand, uint32_t now_ms) {
+    if (motor >= MOTOR_COUNT) {
+        return 0;
+    }
+    OnOff_t *s = &onoffs[motor];
+    uint32_t elapsed = now_ms - s->switch_ms;       // tran so tick van dung
+    uint32_t on_pm = (params->on_duty_pm > 1000U) ? 1000U : params->on_duty_pm;
+    int32_t full = (int32_t)((on_pm * PWM_DUTY_MAX) / 1000U);
+
+    if (!OnOff_IsRunning(s->state)) {
+        if (!demand) {
+            s->state = ONOFF_STATE_OFF;
+            return 0;
+        }
+        if (s->switched && elapsed < params->min_off_ms) {
+            s->state = ONOFF_STATE_HOLD_OFF;
+            return 0;
+        }
+        s->switch_ms = now_ms;
+        s->switched = true;
+        elapsed = 0;
+    } else if (!demand && elapsed >= params->min_on_ms) {
+        s->state = ONOFF_STATE_OFF;
+        s->switch_ms = now_ms;
+        return 0;
+    }
+
+    // Doc tuyen tinh theo thoi gian tu luc bat, ke ca khi dang giu min_on
+    if (elapsed < params->soft_start_ms) {
+        s->state = demand ? ONOFF_STATE_SOFT_START : ONOFF_STATE_HOLD_ON;
+        return (int32_t)(((uint32_t)full * elapsed) / params->soft_start_ms);
+    }
+    s->state = demand ? ONOFF_STATE_ON : ONOFF_STATE_HOLD_ON;
+    return full;
+}
+
+OnOff_State_t OnOff_GetState(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? onoffs[motor].state : ONOFF_STATE_OFF;
+}
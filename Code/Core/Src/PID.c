@@ -5,4 +5,89 @@
  *      Author: ASUS
  */
 
+#include "PID.h"
+#include "FixedPoint.h"
 
+void PID_Init(PID_t *pid, int32_t out_min, int32_t out_max) {
+    pid->kp = 0;
+    pid->ki = 0;
+    pid->kd = 0;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    PID_Reset(pid, 0, 0);
+}
+
+void PID_SetGains(PID_t *pid, int32_t kp_q16, int32_t ki_q24, int32_t kd_q16) {
+    pid->kp = kp_q16;
+    pid->ki = ki_q24;
+    pid->kd = kd_q16;
+}
+
+static void PID_ClampIntegral(PID_t *pid) {
+    int64_t lo = (int64_t)pid->out_min << 24;
+    int64_t hi = (int64_t)pid->out_max << 24;
+
+    if (pid->integral > hi) {
+        pid->integral = hi;
+    } else if (pid->integral < lo) {
+        pid->integral = lo;
+    }
+}
+
+void PID_SetGainsBumpless(PID_t *pid, int32_t kp_q16, int32_t ki_q24, int32_t kd_q16) {
+    if (kp_q16 != pid->kp) {
+        pid->integral += ((int64_t)(pid->kp - kp_q16) * pid->prev_error) << 8;  // Q16 -> Q24
+        PID_ClampIntegral(pid);
+    }
+    PID_SetGains(pid, kp_q16, ki_q24, kd_q16);
+}
+
+void PID_SetLimits(PID_t *pid, int32_t out_min, int32_t out_max) {
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    PID_ClampIntegral(pid);
+}
+
+void PID_Reset(PID_t *pid, int32_t measurement, int32_t output) {
+    output = FP_Saturate(output, pid->out_min, pid->out_max);
+    pid->integral = (int64_t)output << 24;
+    pid->prev_measurement = measurement;
+    pid->prev_error = 0;
+    pid->output = output;
+}
+
+void PID_Track(PID_t *pid, int32_t setpoint, int32_t measurement, int32_t feedforward, int32_t output) {
+    int32_t error = setpoint - measurement;
+    int64_t p = (((int64_t)pid->kp * error) >> 16) + feedforward;   // D = 0: do luong chua doi
+
+    output = FP_Saturate(output, pid->out_min, pid->out_max);
+    pid->integral = ((int64_t)output - p) << 24;
+    PID_ClampIntegral(pid);
+    pid->prev_measurement = measurement;
+    pid->prev_error = error;
+    pid->output = output;
+}
+
+int32_t PID_Update(PID_t *pid, int32_t setpoint, int32_t measurement) {
+    return PID_UpdateFF(pid, setpoint, measurement, 0);
+}
+
+int32_t PID_UpdateFF(PID_t *pid, int32_t setpoint, int32_t measurement, int32_t feedforward) {
+    int32_t error = setpoint - measurement;
+    int64_t pd = (((int64_t)pid->kp * error -
+                   (int64_t)pid->kd * (measurement - pid->prev_measurement)) >> 16) + feedforward;
+    int64_t u = pd + (pid->integral >> 24);
+
+    pid->prev_measurement = measurement;
+    pid->prev_error = error;
+
+    // Conditional integration: khong tich them khi da bao hoa cung chieu
+    if (!((u >= pid->out_max && error > 0) || (u <= pid->out_min && error < 0))) {
+        pid->integral += (int64_t)pid->ki * error;
+        PID_ClampIntegral(pid);
+        u = pd + (pid->integral >> 24);
+    }
+
+    pid->output = FP_Saturate(u, pid->out_min, pid->out_max);
+    return pid->output;
+}
@@ -0,0 +1,538 @@
+/*
+ * PWM.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "PWM.h"
+#include "Config.h"
+#include "Timing.h"
+#include "main.h"
+
+extern TIM_HandleTypeDef htim1;
+extern TIM_HandleTypeDef htim3;
+
+typedef struct {
+    TIM_HandleTypeDef *htim;
+    uint32_t channel;
+    uint32_t low_channel;           // khoa duoi gia lap (timer khong co CHxN)
+    bool hw_complementary;          // CHxN + dead-time phan cung (TIM1)
+    GPIO_TypeDef *dir_a_port;
+    uint16_t dir_a_pin;
+    GPIO_TypeDef *dir_b_port;
+    uint16_t dir_b_pin;
+} PWM_Output_t;
+
+static const PWM_Output_t pwm_outputs[MOTOR_COUNT] = {
+    { &htim3, TIM_CHANNEL_3, TIM_CHANNEL_2, false, DIR1_GPIO_Port, DIR1_Pin, DIR2_GPIO_Port, DIR2_Pin },
+    { &htim1, TIM_CHANNEL_1, TIM_CHANNEL_1, true,  DIR3_GPIO_Port, DIR3_Pin, DIR4_GPIO_Port, DIR4_Pin },
+};
+
+#define PWM_SAMPLE_CHANNEL      TIM_CHANNEL_2   // TIM1_CC2 = trigger ADC1 (CurrentSense.c)
+#define PWM_DEAD_TICKS_MAX      1008U           // DTG = 111x xxxx: (32 + 31) * 16 tDTS
+
+static uint32_t pwm_frequency = CONFIG_PWM_FREQUENCY_HZ;
+static PWM_Align_t pwm_align = PWM_ALIGN_EDGE;
+static uint32_t pwm_steps[MOTOR_COUNT];     // duty steps per period of each timer
+static int16_t pwm_duty[MOTOR_COUNT];       // last requested duty (Q15)
+static volatile bool pwm_stopped;
+static PWM_OutputMode_t pwm_output_mode = PWM_OUTPUT_MODE_SINGLE;
+static uint32_t pwm_dead_ns;                // dead-time yeu cau (ns)
+static uint16_t pwm_dead_ns_actual;         // sau khi lam tron theo DTG
+static uint32_t pwm_dead_ticks[MOTOR_COUNT];// gia lap: buoc counter (sau PSC)
+static bool pwm_low_pins_ready;
+static uint32_t pwm_min_pulse_ns;           // 0 = khong gioi han
+static uint32_t pwm_min_ticks[MOTOR_COUNT];
+static bool pwm_dither;
+static int32_t pwm_residue[MOTOR_COUNT];    // sai so luong tu hoa tich luy (Q8 buoc)
+
+// CCR giu output muc cao ca chu ky: edge-aligned steps = ARR + 1, center-aligned
+// steps = ARR nen can ARR + 1 (CCR = ARR de lai mot xung tat 1 buoc o dinh)
+static uint32_t PWM_FullOnCompare(uint8_t motor) {
+    return (pwm_align == PWM_ALIGN_CENTER) ? pwm_steps[motor] + 1U : pwm_steps[motor];
+}
+
+static uint32_t PWM_DutyToCompare(uint8_t motor, int16_t duty) {
+    uint32_t magnitude = (duty < 0) ? (uint32_t)(-(int32_t)duty) : (uint32_t)duty;
+    if (magnitude >= PWM_DUTY_MAX) {
+        return PWM_FullOnCompare(motor);    // 100%: CCR > ARR keeps output high
+    }
+    return (magnitude * pwm_steps[motor]) >> 15;
+}
+
+// Duty -> CCR qua bo hau xu ly. Xung bat (hoac tat, gan 100 %) ngan hon
+// pwm_min_ticks bi bo hoac keo dai thanh min. dither: phan duoi mot buoc va
+// phan bi bo / keo dai don sang tick sau (sigma-delta bac 1) nen duty trung
+// binh giu nguyen. Goi voi ngat da tat
+static uint32_t PWM_Quantize(uint8_t motor, bool dither) {
+    int16_t duty = pwm_duty[motor];
+    uint32_t magnitude = (duty < 0) ? (uint32_t)(-(int32_t)duty) : (uint32_t)duty;
+    uint32_t steps = pwm_steps[motor];
+    uint32_t min = pwm_min_ticks[motor];
+    int32_t want, limit;
+    uint32_t out;
+
+    if (magnitude == 0U || magnitude >= PWM_DUTY_MAX) {
+        pwm_residue[motor] = 0;
+        return PWM_DutyToCompare(motor, duty);
+    }
+    want = (int32_t)((magnitude * steps) >> 7);     // Q8 buoc, steps <= 65536
+    if (dither) {
+        want += pwm_residue[motor];
+    }
+    out = (want <= 0) ? 0U : (uint32_t)want >> 8;
+    if (out > steps) {
+        out = steps;
+    }
+    if (out > 0U && out < min) {
+        out = (2 * want >= (int32_t)(min << 8)) ? min : 0U;
+    }
+    if (out < steps && steps - out < min) {
+        out = (2 * want >= (int32_t)((2U * steps - min) << 8)) ? steps : steps - min;
+    }
+    if (dither) {
+        limit = (int32_t)(((min > 1U) ? min : 1U) << 8);
+        want -= (int32_t)(out << 8);
+        pwm_residue[motor] = (want > limit) ? limit : ((want < -limit) ? -limit : want);
+    }
+    return (out >= steps) ? PWM_FullOnCompare(motor) : out;
+}
+
+static void PWM_WriteDirection(uint8_t motor, int16_t duty) {
+    const PWM_Output_t *out = &pwm_outputs[motor];
+    if (duty > 0) {
+        HAL_GPIO_WritePin(out->dir_b_port, out->dir_b_pin, GPIO_PIN_RESET);
+        HAL_GPIO_WritePin(out->dir_a_port, out->dir_a_pin, GPIO_PIN_SET);
+    } else if (duty < 0) {
+        HAL_GPIO_WritePin(out->dir_a_port, out->dir_a_pin, GPIO_PIN_RESET);
+        HAL_GPIO_WritePin(out->dir_b_port, out->dir_b_pin, GPIO_PIN_SET);
+    }
+    // duty == 0: giu nguyen chieu, PWM = 0 la du de ngat cau H
+}
+
+// Khoa duoi cua nhanh PWM (chinh luu dong bo), goi voi ngat da tat.
+// Duty 0: tat ca hai khoa de cau H tha troi nhu output don
+static void PWM_WriteLowSide(uint8_t motor, uint32_t compare) {
+    const PWM_Output_t *out = &pwm_outputs[motor];
+    TIM_TypeDef *tim = out->htim->Instance;
+    bool on = pwm_output_mode == PWM_OUTPUT_MODE_COMPLEMENTARY && pwm_duty[motor] != 0;
+
+    if (out->hw_complementary) {
+        if (on) {
+            tim->CCER |= TIM_CCER_CC1NE;
+        } else {
+            tim->CCER &= ~TIM_CCER_CC1NE;   // OSSR = 1: CH1N giu muc inactive
+        }
+        return;
+    }
+
+    // PWM2 tren low_channel: dan khi CNT >= CCR + dead. Edge-aligned khong co
+    // dead-time o dau chu ky (CCR3 len cung luc low_channel xuong) -> giu tat
+    on = on && pwm_align == PWM_ALIGN_CENTER;
+    __HAL_TIM_SET_COMPARE(out->htim, out->low_channel, compare + pwm_dead_ticks[motor]);
+    if (on) {
+        TIM_CCxChannelCmd(tim, out->low_channel, TIM_CCx_ENABLE);
+    } else {
+        TIM_CCxChannelCmd(tim, out->low_channel, TIM_CCx_DISABLE);
+    }
+}
+
+// Dead-time gia lap va xung toi thieu theo tan so dem thuc te (PSC thay doi
+// theo tan so PWM), lam tron len
+static void PWM_UpdateDeadTicks(void) {
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        TIM_TypeDef *tim = pwm_outputs[i].htim->Instance;
+        uint64_t clk = Timing_GetTimerClockHz(tim) / (tim->PSC + 1U);
+        uint32_t min = (uint32_t)(((uint64_t)pwm_min_pulse_ns * clk + 999999999ULL) / 1000000000ULL);
+        pwm_dead_ticks[i] = (uint32_t)(((uint64_t)pwm_dead_ns * clk + 999999999ULL) / 1000000000ULL);
+        // Con lai it nhat nua chu ky cho duty o giua
+        pwm_min_ticks[i] = (min > pwm_steps[i] / 4U) ? pwm_steps[i] / 4U : min;
+    }
+}
+
+// Dat diem lay mau ADC (TIM1 CCR2) vao giua thoi gian dan
+static void PWM_UpdateSamplePoint(void) {
+    uint32_t point;
+    if (pwm_align == PWM_ALIGN_CENTER) {
+        point = 1U;                         // day counter = giua xung (center-aligned)
+    } else {
+        uint32_t on_time = 0;
+        for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+            uint32_t ccr = __HAL_TIM_GET_COMPARE(pwm_outputs[i].htim, pwm_outputs[i].channel);
+            if (ccr > on_time) {
+                on_time = ccr;
+            }
+        }
+        point = on_time / 2U;
+        if (point == 0) {
+            point = 1U;
+        }
+    }
+    uint32_t arr = __HAL_TIM_GET_AUTORELOAD(&htim1);
+    if (point >= arr) {
+        point = arr - 1U;
+    }
+    __HAL_TIM_SET_COMPARE(&htim1, PWM_SAMPLE_CHANNEL, point);
+}
+
+// Tinh PSC/ARR cho tan so mong muon, PSC nho nhat => ARR (do phan giai) lon nhat
+static void PWM_ComputeTimebase(uint32_t timer_clk, uint32_t freq_hz, PWM_Align_t align,
+                                uint32_t *psc, uint32_t *arr, uint32_t *steps) {
+    uint32_t counts = timer_clk / freq_hz;
+    if (align == PWM_ALIGN_CENTER) {
+        counts /= 2U;                       // dem len + dem xuong trong mot chu ky
+    }
+    uint32_t prescaler = counts / 0x10000U + 1U;
+    uint32_t period = (counts + prescaler / 2U) / prescaler;
+
+    *psc = prescaler - 1U;
+    if (align == PWM_ALIGN_CENTER) {
+        *arr = period;                      // f = clk / ((PSC+1) * 2 * ARR)
+        *steps = period;
+    } else {
+        *arr = period - 1U;                 // f = clk / ((PSC+1) * (ARR+1))
+        *steps = period;
+    }
+}
+
+void PWM_Init(void) {
+    TIM_OC_InitTypeDef sConfigOC = {0};
+    TIM_SlaveConfigTypeDef sSlaveConfig = {0};
+
+    // TIM3 chay theo TIM1 (ITR0, trigger mode): hai kenh PWM cung pha
+    sSlaveConfig.SlaveMode = TIM_SLAVEMODE_TRIGGER;
+    sSlaveConfig.InputTrigger = TIM_TS_ITR0;
+    if (HAL_TIM_SlaveConfigSynchro(&htim3, &sSlaveConfig) != HAL_OK) {
+        Error_Handler();
+    }
+
+    // TIM1 CH2 khong ra chan (PA9 la GPIO DIR3), chi dung lam trigger ADC
+    sConfigOC.OCMode = TIM_OCMODE_PWM2;
+    sConfigOC.Pulse = 1;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_PWM_ConfigChannel(&htim1, &sConfigOC, PWM_SAMPLE_CHANNEL) != HAL_OK) {
+        Error_Handler();
+    }
+
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        TIM_HandleTypeDef *htim = pwm_outputs[i].htim;
+        pwm_steps[i] = __HAL_TIM_GET_AUTORELOAD(htim) + 1U;
+        pwm_duty[i] = 0;
+        __HAL_TIM_SET_COMPARE(htim, pwm_outputs[i].channel, 0);
+    }
+
+    // TIM3 (slave) truoc: counter chi chay khi TIM1 bat CEN
+    HAL_TIM_PWM_Start(&htim3, TIM_CHANNEL_3);
+    HAL_TIM_PWM_Start(&htim1, TIM_CHANNEL_1);
+    HAL_TIM_PWM_Start(&htim1, PWM_SAMPLE_CHANNEL);
+
+    PWM_Configure(CONFIG_PWM_FREQUENCY_HZ, PWM_ALIGN_EDGE);
+}
+
+bool PWM_Configure(uint32_t freq_hz, PWM_Align_t align) {
+    if (freq_hz < CONFIG_PWM_FREQUENCY_MIN_HZ || freq_hz > CONFIG_PWM_FREQUENCY_MAX_HZ ||
+        (align != PWM_ALIGN_EDGE && align != PWM_ALIGN_CENTER)) {
+        return false;
+    }
+
+    uint32_t psc[MOTOR_COUNT], arr[MOTOR_COUNT], steps[MOTOR_COUNT];
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        PWM_ComputeTimebase(Timing_GetTimerClockHz(pwm_outputs[i].htim->Instance),
+                            freq_hz, align, &psc[i], &arr[i], &steps[i]);
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+
+    bool restart = (align != pwm_align);
+    if (restart) {
+        // CMS chi doi duoc khi counter dung (RM0008 15.4.1)
+        for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+            __HAL_TIM_DISABLE(pwm_outputs[i].htim);
+        }
+    }
+
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        TIM_TypeDef *tim = pwm_outputs[i].htim->Instance;
+        pwm_steps[i] = steps[i];
+        if (restart) {
+            MODIFY_REG(tim->CR1, TIM_CR1_CMS,
+                       (align == PWM_ALIGN_CENTER) ? TIM_COUNTERMODE_CENTERALIGNED1
+                                                   : TIM_COUNTERMODE_UP);
+        }
+        // PSC, ARR (ARPE) va CCR (OCxPE) deu preload: chot cung luc o update event
+        tim->PSC = psc[i];
+        tim->ARR = arr[i];
+        pwm_outputs[i].htim->Init.Prescaler = psc[i];
+        pwm_outputs[i].htim->Init.Period = arr[i];
+        pwm_outputs[i].htim->Init.CounterMode = (align == PWM_ALIGN_CENTER)
+                                              ? TIM_COUNTERMODE_CENTERALIGNED1
+                                              : TIM_COUNTERMODE_UP;
+    }
+
+    pwm_frequency = freq_hz;
+    pwm_align = align;
+    PWM_UpdateDeadTicks();
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        uint32_t compare = PWM_Quantize(i, false);
+        pwm_residue[i] = 0;
+        __HAL_TIM_SET_COMPARE(pwm_outputs[i].htim, pwm_outputs[i].channel, compare);
+        PWM_WriteLowSide(i, compare);
+    }
+    PWM_UpdateSamplePoint();
+
+    if (restart) {
+        for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+            TIM_TypeDef *tim = pwm_outputs[i].htim->Instance;
+            tim->CNT = 0;
+            tim->EGR = TIM_EGR_UG;          // nap preload ngay
+        }
+        __HAL_TIM_ENABLE(&htim1);           // TIM3 duoc trigger qua ITR0
+    }
+
+    __set_PRIMASK(primask);
+    return true;
+}
+
+void PWM_SetDuty(uint8_t motor, int16_t duty) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    if (duty < -PWM_DUTY_MAX) {
+        duty = -PWM_DUTY_MAX;
+    }
+    PWM_WriteDirection(motor, duty);
+
+    // PWM_Configure() co the doi pwm_steps giua chung
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    pwm_duty[motor] = duty;
+    // Cung tich sai so voi PWM_Dither(): lan ghi nay cung la mot mau sigma-delta,
+    // neu khong moi ms co mot tick duty chua dither ma residue khong bu
+    uint32_t compare = PWM_Quantize(motor, pwm_dither);
+    __HAL_TIM_SET_COMPARE(pwm_outputs[motor].htim, pwm_outputs[motor].channel, compare);
+    PWM_WriteLowSide(motor, compare);
+    PWM_UpdateSamplePoint();
+    __set_PRIMASK(primask);
+}
+
+void PWM_Brake(uint8_t motor, int16_t strength) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    if (strength < 0) {
+        strength = 0;
+    }
+    const PWM_Output_t *out = &pwm_outputs[motor];
+    HAL_GPIO_WritePin(out->dir_a_port, out->dir_a_pin, GPIO_PIN_RESET);
+    HAL_GPIO_WritePin(out->dir_b_port, out->dir_b_pin, GPIO_PIN_RESET);
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    pwm_duty[motor] = strength;
+    uint32_t compare = PWM_Quantize(motor, pwm_dither);
+    __HAL_TIM_SET_COMPARE(out->htim, out->channel, compare);
+    PWM_WriteLowSide(motor, compare);
+    PWM_UpdateSamplePoint();
+    __set_PRIMASK(primask);
+}
+
+// Ghi OCxM truc tiep (khong preload) cho kenh HAL TIM_CHANNEL_x
+static void PWM_SetOcMode(TIM_TypeDef *tim, uint32_t channel, uint32_t mode) {
+    switch (channel) {
+        case TIM_CHANNEL_1: MODIFY_REG(tim->CCMR1, TIM_CCMR1_OC1M, mode); break;
+        case TIM_CHANNEL_2: MODIFY_REG(tim->CCMR1, TIM_CCMR1_OC2M, mode << 8U); break;
+        case TIM_CHANNEL_3: MODIFY_REG(tim->CCMR2, TIM_CCMR2_OC3M, mode); break;
+        case TIM_CHANNEL_4: MODIFY_REG(tim->CCMR2, TIM_CCMR2_OC4M, mode << 8U); break;
+        default: break;
+    }
+}
+
+void PWM_EmergencyStop(void) {
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        TIM_TypeDef *tim = pwm_outputs[i].htim->Instance;
+        if (IS_TIM_BREAK_INSTANCE(tim)) {
+            tim->EGR = TIM_EGR_BG;          // MOE = 0 trong 1 chu ky clock
+        } else {
+            PWM_SetOcMode(tim, pwm_outputs[i].channel, TIM_OCMODE_FORCED_INACTIVE);
+            PWM_SetOcMode(tim, pwm_outputs[i].low_channel, TIM_OCMODE_FORCED_INACTIVE);
+        }
+        __HAL_TIM_SET_COMPARE(pwm_outputs[i].htim, pwm_outputs[i].channel, 0);
+        pwm_duty[i] = 0;
+    }
+    pwm_stopped = true;
+}
+
+void PWM_Resume(void) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        TIM_HandleTypeDef *htim = pwm_outputs[i].htim;
+        pwm_duty[i] = 0;
+        __HAL_TIM_SET_COMPARE(htim, pwm_outputs[i].channel, 0);
+        PWM_WriteLowSide(i, 0);
+        if (IS_TIM_BREAK_INSTANCE(htim->Instance)) {
+            __HAL_TIM_MOE_ENABLE(htim);
+        } else {
+            PWM_SetOcMode(htim->Instance, pwm_outputs[i].channel, TIM_OCMODE_PWM1);
+            PWM_SetOcMode(htim->Instance, pwm_outputs[i].low_channel, TIM_OCMODE_PWM2);
+        }
+    }
+    pwm_stopped = false;
+    __set_PRIMASK(primask);
+}
+
+// So tick dead-time -> ma DTG (RM0008 TIMx_BDTR), lam tron len buoc gan nhat
+static bool PWM_EncodeDeadTime(uint32_t ticks, uint32_t *dtg, uint32_t *actual) {
+    uint32_t n;
+
+    if (ticks <= 127U) {
+        *dtg = ticks;
+        *actual = ticks;
+    } else if (ticks <= 254U) {
+        n = (ticks + 1U) / 2U;              // (64 + DTG[5:0]) * 2
+        *dtg = 0x80U | (n - 64U);
+        *actual = n * 2U;
+    } else if (ticks <= 504U) {
+        n = (ticks + 7U) / 8U;              // (32 + DTG[4:0]) * 8
+        *dtg = 0xC0U | (n - 32U);
+        *actual = n * 8U;
+    } else if (ticks <= PWM_DEAD_TICKS_MAX) {
+        n = (ticks + 15U) / 16U;            // (32 + DTG[4:0]) * 16
+        *dtg = 0xE0U | (n - 32U);
+        *actual = n * 16U;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// Khoa duoi Motor 1 (gia lap) ra PB5: TIM3 partial remap dua CH1/CH2 sang PB4/PB5.
+// CH1 khong bat nen PB4 (OUT1, GPIO) khong bi anh huong
+static void PWM_InitLowSidePins(void) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    TIM_OC_InitTypeDef sConfigOC = {0};
+
+    __HAL_RCC_AFIO_CLK_ENABLE();
+    __HAL_AFIO_REMAP_TIM3_PARTIAL();
+    GPIO_InitStruct.Pin = GPIO_PIN_5;
+    GPIO_InitStruct.Mode = GPIO_MODE_AF_PP;
+    GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_HIGH;
+    HAL_GPIO_Init(GPIOB, &GPIO_InitStruct);
+
+    sConfigOC.OCMode = TIM_OCMODE_PWM2;
+    sConfigOC.Pulse = __HAL_TIM_GET_AUTORELOAD(&htim3) + 1U;
+    sConfigOC.OCPolarity = TIM_OCPOLARITY_HIGH;
+    sConfigOC.OCFastMode = TIM_OCFAST_DISABLE;
+    if (HAL_TIM_PWM_ConfigChannel(&htim3, &sConfigOC, pwm_outputs[0].low_channel) != HAL_OK) {
+        Error_Handler();
+    }
+    pwm_low_pins_ready = true;
+}
+
+bool PWM_SetOutputMode(PWM_OutputMode_t mode, uint32_t dead_time_ns) {
+    uint32_t clk = Timing_GetTimerClockHz(TIM1);    // CKD = DIV1: tDTS = 1 / clk
+    uint32_t ticks = (uint32_t)(((uint64_t)dead_time_ns * clk + 999999999ULL) / 1000000000ULL);
+    uint32_t dtg, actual;
+
+    if ((mode != PWM_OUTPUT_MODE_SINGLE && mode != PWM_OUTPUT_MODE_COMPLEMENTARY) ||
+        !PWM_EncodeDeadTime(ticks, &dtg, &actual)) {
+        return false;
+    }
+    if (mode == PWM_OUTPUT_MODE_COMPLEMENTARY && !pwm_low_pins_ready) {
+        PWM_InitLowSidePins();
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    // Output don: DTG = 0 va OSSR = 0 nhu cau hinh CubeMX
+    if (mode == PWM_OUTPUT_MODE_COMPLEMENTARY) {
+        MODIFY_REG(TIM1->BDTR, TIM_BDTR_DTG | TIM_BDTR_OSSR, dtg | TIM_BDTR_OSSR);
+    } else {
+        MODIFY_REG(TIM1->BDTR, TIM_BDTR_DTG | TIM_BDTR_OSSR, 0U);
+    }
+    pwm_output_mode = mode;
+    pwm_dead_ns = dead_time_ns;
+    // Lam tron len theo buoc DTG: van >= gia tri yeu cau, doi lai ns de master doc dung so tick
+    pwm_dead_ns_actual = (uint16_t)(((uint64_t)actual * 1000000000ULL) / clk);
+    PWM_UpdateDeadTicks();
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        PWM_WriteLowSide(i, __HAL_TIM_GET_COMPARE(pwm_outputs[i].htim, pwm_outputs[i].channel));
+    }
+    __set_PRIMASK(primask);
+    return true;
+}
+
+void PWM_SetPostProcess(uint32_t min_pulse_ns, bool dither) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    pwm_min_pulse_ns = min_pulse_ns;
+    pwm_dither = dither;
+    PWM_UpdateDeadTicks();
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        uint32_t compare = PWM_Quantize(i, false);
+        pwm_residue[i] = 0;
+        __HAL_TIM_SET_COMPARE(pwm_outputs[i].htim, pwm_outputs[i].channel, compare);
+        PWM_WriteLowSide(i, compare);
+    }
+    PWM_UpdateSamplePoint();
+    __set_PRIMASK(primask);
+}
+
+void PWM_Dither(void) {
+    if (!pwm_dither || pwm_stopped) {
+        return;
+    }
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    for (uint8_t i = 0; i < MOTOR_COUNT; i++) {
+        uint32_t compare = PWM_Quantize(i, true);
+        __HAL_TIM_SET_COMPARE(pwm_outputs[i].htim, pwm_outputs[i].channel, compare);
+        PWM_WriteLowSide(i, compare);
+    }
+    PWM_UpdateSamplePoint();
+    __set_PRIMASK(primask);
+}
+
+bool PWM_IsStopped(void) {
+    return pwm_stopped;
+}
+
+uint32_t PWM_GetFrequency(void) {
+    return pwm_frequency;
+}
+
+PWM_Align_t PWM_GetAlign(void) {
+    return pwm_align;
+}
+
+PWM_OutputMode_t PWM_GetOutputMode(void) {
+    return pwm_output_mode;
+}
+
+uint16_t PWM_GetDeadTime(void) {
+    return pwm_dead_ns_actual;
+}
+
+uint16_t PWM_GetMinPulse(void) {
+    return (pwm_min_pulse_ns > 0xFFFFU) ? 0xFFFFU : (uint16_t)pwm_min_pulse_ns;
+}
+
+bool PWM_GetDither(void) {
+    return pwm_dither;
+}
+
+uint16_t PWM_GetMinDuty(void) {
+    uint32_t steps = pwm_steps[0];
+    if (steps == 0U) {
+        return 0;
+    }
+    return (uint16_t)((pwm_min_ticks[0] * 1000U + steps - 1U) / steps);
+}
+
+uint16_t PWM_GetResolution(void) {
+    uint32_t steps = pwm_steps[0];
+    return (steps > 0xFFFFU) ? 0xFFFFU : (uint16_t)steps;
+}
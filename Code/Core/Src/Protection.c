@@ -0,0 +1,100 @@
+/*
+ * Protection.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Protection.h"
+#include "main.h"
+#include "Config.h"
+#include "ModbusMap.h"
+#include "PWM.h"
+#include "CurrentSense.h"
+
+#define PROTECTION_IRQ_PRIORITY 0U      // tren configMAX_SYSCALL, khong goi RTOS trong ISR
+
+static volatile bool ocp_tripped;
+static uint16_t armed_threshold_ma;     // nguong dang nap trong HTR/LTR, 0 = tat
+static bool armed;
+
+// Cua so watchdog chung cho moi kenh scan: lay cua so hep nhat giua cac motor
+static void Protection_ArmWatchdog(uint16_t threshold_ma) {
+    uint32_t high = ADC_HTR_HT;
+    uint32_t low = 0;
+
+    for (uint8_t m = 0; m < MOTOR_COUNT; m++) {
+        uint32_t h = CurrentSense_MilliAmpsToRaw(m, threshold_ma);
+        uint32_t l = CurrentSense_MilliAmpsToRaw(m, -(int32_t)threshold_ma);
+        if (h < high) {
+            high = h;
+        }
+        if (l > low) {
+            low = l;
+        }
+    }
+
+    ADC1->CR1 &= ~(ADC_CR1_AWDEN | ADC_CR1_AWDIE);
+    if (threshold_ma != 0U) {
+        ADC1->HTR = high;
+        ADC1->LTR = low;
+        ADC1->SR &= ~ADC_SR_AWD;
+        ADC1->CR1 |= ADC_CR1_AWDEN | ADC_CR1_AWDIE;     // AWDSGL = 0: moi kenh regular
+    }
+    armed_threshold_ma = threshold_ma;
+}
+
+static void Protection_Reset(void) {
+    g_modbus_data.m1.error = MOTOR_ERR_NONE;
+    g_modbus_data.m2.error = MOTOR_ERR_NONE;
+    g_modbus_data.system_error = 0;
+
+    if (ocp_tripped) {
+        ocp_tripped = false;
+        PWM_Resume();
+        // Neu dong van con vuot nguong, watchdog se trip lai ngay lan chuyen doi sau
+        Protection_ArmWatchdog(g_modbus_data.ocp_threshold_ma);
+    }
+}
+
+void Protection_Init(void) {
+    ocp_tripped = false;
+    armed = false;
+    HAL_NVIC_SetPriority(ADC1_2_IRQn, PROTECTION_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(ADC1_2_IRQn);
+}
+
+void Protection_Update(void) {
+    if (g_modbus_data.reset_error_cmd != 0U) {
+        Protection_Reset();
+        g_modbus_data.reset_error_cmd = 0;
+    }
+
+    // Offset zero chi co sau khi CurrentSense hieu chuan xong
+    if (!CurrentSense_IsReady() || ocp_tripped) {
+        return;
+    }
+    if (!armed || g_modbus_data.ocp_threshold_ma != armed_threshold_ma) {
+        Protection_ArmWatchdog(g_modbus_data.ocp_threshold_ma);
+        armed = true;
+    }
+}
+
+void Protection_IRQHandler(void) {
+    if ((ADC1->SR & ADC_SR_AWD) == 0U) {
+        return;
+    }
+
+    PWM_EmergencyStop();
+    ADC1->CR1 &= ~ADC_CR1_AWDIE;        // chi bao mot lan, bat lai khi reset loi
+    ADC1->SR &= ~ADC_SR_AWD;
+
+    ocp_tripped = true;
+    // Cam bien dat o nguon cau H chung: khong phan biet duoc motor nao, chot ca hai
+    g_modbus_data.m1.error = MOTOR_ERR_OVERCURRENT;
+    g_modbus_data.m2.error = MOTOR_ERR_OVERCURRENT;
+}
+
+bool Protection_IsTripped(void) {
+    return ocp_tripped;
+}
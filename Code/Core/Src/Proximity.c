@@ -0,0 +1,188 @@
+/*
+ * Proximity.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Proximity.h"
+#include "main.h"
+#include "ModbusMap.h"
+#include "Timing.h"
+
+#define PROXIMITY_IRQ_PRIORITY  6U      // sau Modbus (5), khong goi RTOS trong ISR
+#define TFMINI_BAUDRATE         115200U
+#define TFMINI_HEADER           0x59U
+#define TFMINI_FRAME_LEN        9U
+#define A02_BAUDRATE            9600U
+#define A02_HEADER              0xFFU
+#define A02_FRAME_LEN           4U
+
+/* Ghi trong ISR */
+static volatile uint16_t uart_cm = PROXIMITY_DISTANCE_FAR;
+static volatile uint16_t uart_frames;
+static uint8_t frame[TFMINI_FRAME_LEN];
+static uint8_t frame_index;
+static volatile uint16_t uart_source;
+
+/* Chi dung trong task */
+static uint16_t active_source = PROXIMITY_SOURCE_OFF;
+static uint16_t seen_frames;
+static uint32_t last_frame_ms;
+static uint16_t distance_cm = PROXIMITY_DISTANCE_FAR;
+static int32_t scale = PROXIMITY_SCALE_FULL;
+static bool lost;
+
+static bool Proximity_IsUart(uint16_t source) {
+    return source == PROXIMITY_SOURCE_TFMINI || source == PROXIMITY_SOURCE_A02;
+}
+
+// USART1 chi nhan (PA10). MX_USART1_UART_Init (Driver.ioc) chi khoi tao 9600 baud, khong
+// bat ngat: baud va RXNEIE doi theo nguon nen cau hinh truc tiep thanh ghi
+static void Proximity_ConfigureUart(uint16_t source) {
+    GPIO_InitTypeDef GPIO_InitStruct = {0};
+    uint32_t baud = (source == PROXIMITY_SOURCE_TFMINI) ? TFMINI_BAUDRATE : A02_BAUDRATE;
+
+    HAL_NVIC_DisableIRQ(USART1_IRQn);
+    USART1->CR1 = 0;
+    uart_source = source;
+    frame_index = 0;
+    uart_cm = PROXIMITY_DISTANCE_FAR;
+    if (!Proximity_IsUart(source)) {
+        return;
+    }
+
+    __HAL_RCC_USART1_CLK_ENABLE();
+    __HAL_RCC_GPIOA_CLK_ENABLE();
+    GPIO_InitStruct.Pin = GPIO_PIN_10;
+    GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+    GPIO_InitStruct.Pull = GPIO_PULLUP;
+    HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
+
+    USART1->BRR = (g_timing.pclk2_hz + baud / 2U) / baud;
+    USART1->CR2 = 0;
+    USART1->CR3 = 0;
+    (void)USART1->SR;
+    (void)USART1->DR;
+    USART1->CR1 = USART_CR1_UE | USART_CR1_RE | USART_CR1_RXNEIE;
+    HAL_NVIC_SetPriority(USART1_IRQn, PROXIMITY_IRQ_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(USART1_IRQn);
+}
+
+// TFmini / TF-Luna: 59 59 DistL DistH StrL StrH TempL TempH Sum, cm
+static void Proximity_ParseTfmini(uint8_t byte) {
+    uint8_t sum = 0;
+
+    if (frame_index < 2U && byte != TFMINI_HEADER) {
+        frame_index = 0;
+        return;
+    }
+    frame[frame_index++] = byte;
+    if (frame_index < TFMINI_FRAME_LEN) {
+        return;
+    }
+    frame_index = 0;
+    for (uint8_t i = 0; i < TFMINI_FRAME_LEN - 1U; i++) {
+        sum = (uint8_t)(sum + frame[i]);
+    }
+    if (sum == frame[TFMINI_FRAME_LEN - 1U]) {
+        uart_cm = (uint16_t)(frame[2] | ((uint16_t)frame[3] << 8));  // 0xFFFF: tin hieu yeu = khong co vat
+        uart_frames++;
+    }
+}
+
+// A02YYUW: FF DistH DistL Sum, mm
+static void Proximity_ParseA02(uint8_t byte) {
+    if (frame_index == 0U && byte != A02_HEADER) {
+        return;
+    }
+    frame[frame_index++] = byte;
+    if (frame_index < A02_FRAME_LEN) {
+        return;
+    }
+    frame_index = 0;
+    if ((uint8_t)(frame[0] + frame[1] + frame[2]) == frame[3]) {
+        uart_cm = (uint16_t)((((uint16_t)frame[1] << 8) | frame[2]) / 10U);
+        uart_frames++;
+    }
+}
+
+void Proximity_IRQHandler(void) {
+    uint32_t sr = USART1->SR;
+    uint8_t byte = (uint8_t)USART1->DR;     // doc DR xoa RXNE va ORE
+
+    if ((sr & USART_SR_RXNE) == 0U) {
+        return;
+    }
+    if ((sr & (USART_SR_FE | USART_SR_NE)) != 0U) {
+        frame_index = 0;
+        return;
+    }
+    if (uart_source == PROXIMITY_SOURCE_TFMINI) {
+        Proximity_ParseTfmini(byte);
+    } else {
+        Proximity_ParseA02(byte);
+    }
+}
+
+// safe -> creep, slow -> 1.0, tuyen tinh o giua (Q15)
+static int32_t Proximity_Curve(const Proximity_Params_t *params, uint16_t d) {
+    uint32_t creep = (params->creep_pct > 100U) ? 100U : params->creep_pct;
+    int32_t creep_q15 = (int32_t)((creep * PROXIMITY_SCALE_FULL) / 100U);
+    int32_t frac;
+
+    if (d <= params->safe_cm) {
+        return 0;
+    }
+    if (params->slow_cm <= params->safe_cm || d >= params->slow_cm) {
+        return PROXIMITY_SCALE_FULL;
+    }
+    frac = (int32_t)(((uint32_t)(d - params->safe_cm) * PROXIMITY_SCALE_FULL) /
+                     (uint32_t)(params->slow_cm - params->safe_cm));
+    return creep_q15 + (((PROXIMITY_SCALE_FULL - creep_q15) * frac) >> 15);
+}
+
+void Proximity_Update(uint32_t now_ms, uint16_t source, const Proximity_Params_t *params,
+                      uint16_t external_cm) {
+    if (source != active_source) {
+        Proximity_ConfigureUart(source);
+        active_source = source;
+        seen_frames = uart_frames;
+        last_frame_ms = now_ms;
+    }
+
+    lost = false;
+    if (source == PROXIMITY_SOURCE_OFF) {
+        distance_cm = PROXIMITY_DISTANCE_FAR;
+        scale = PROXIMITY_SCALE_FULL;
+        return;
+    }
+    if (Proximity_IsUart(source)) {
+        uint16_t frames = uart_frames;
+        if (frames != seen_frames) {
+            seen_frames = frames;
+            last_frame_ms = now_ms;
+        }
+        distance_cm = uart_cm;
+        lost = params->timeout_ms != 0U && (now_ms - last_frame_ms) > params->timeout_ms;
+    } else {
+        distance_cm = external_cm;
+    }
+    scale = lost ? 0 : Proximity_Curve(params, distance_cm);
+}
+
+uint16_t Proximity_GetDistance(void) {
+    return distance_cm;
+}
+
+int32_t Proximity_GetScale(void) {
+    return scale;
+}
+
+bool Proximity_IsLost(void) {
+    return lost;
+}
+
+uint16_t Proximity_GetFrames(void) {
+    return uart_frames;
+}
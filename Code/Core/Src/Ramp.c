@@ -0,0 +1,54 @@
+/*
+ * Ramp.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Ramp.h"
+
+void Ramp_Reset(Ramp_t *ramp, int32_t value) {
+    ramp->value_q16 = (int64_t)value << 16;
+    ramp->accel = 0;
+}
+
+int32_t Ramp_Update(Ramp_t *ramp, int32_t target, uint32_t accel_limit,
+                    uint32_t decel_limit, uint32_t loop_hz) {
+    int64_t target_q16 = (int64_t)target << 16;
+    int64_t diff = target_q16 - ramp->value_q16;
+    int64_t step;
+    uint32_t rate;
+
+    if (diff == 0) {
+        ramp->accel = 0;
+        return target;
+    }
+
+    // |ref| tang: gioi han tang toc; |ref| giam ve 0: gioi han giam toc
+    if ((diff > 0 && ramp->value_q16 >= 0) || (diff < 0 && ramp->value_q16 <= 0)) {
+        rate = accel_limit;
+    } else {
+        rate = decel_limit;
+    }
+
+    step = (rate != 0U && loop_hz != 0U) ? (((int64_t)rate << 16) / loop_hz) : 0;
+    if (rate == 0U || (diff <= step && diff >= -step)) {
+        ramp->value_q16 = target_q16;
+        ramp->accel = 0;
+    } else if (diff > 0) {
+        ramp->value_q16 += (step > 0) ? step : 1;
+        ramp->accel = (int32_t)rate;
+    } else {
+        ramp->value_q16 -= (step > 0) ? step : 1;
+        ramp->accel = -(int32_t)rate;
+    }
+    return Ramp_GetValue(ramp);
+}
+
+int32_t Ramp_GetValue(const Ramp_t *ramp) {
+    return (int32_t)((ramp->value_q16 + (1 << 15)) >> 16);
+}
+
+int32_t Ramp_GetAccel(const Ramp_t *ramp) {
+    return ramp->accel;
+}
@@ -0,0 +1,151 @@
+/*
+ * Stall.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Stall.h"
+#include "main.h"
+#include "Config.h"
+#include "PWM.h"
+#include "ModbusMap.h"
+
+typedef struct {
+    Stall_State_t state;
+    uint16_t stall_ticks;       // so tick lien tuc thoa ca ba dieu kien
+    uint16_t clear_ticks;       // so tick chay khong ket (xoa retries)
+    uint32_t backoff_ticks;     // con lai truoc lan thu lai
+    uint16_t retries;
+    uint16_t count;
+} Stall_t;
+
+static Stall_t stalls[MOTOR_COUNT];
+
+void Stall_Reset(uint8_t motor) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    Stall_t *s = &stalls[motor];
+    s->state = STALL_STATE_OK;
+    s->stall_ticks = 0;
+    s->clear_ticks = 0;
+    s->backoff_ticks = 0;
+    s->retries = 0;
+}
+
+bool Stall_Check(uint8_t motor, const Stall_Params_t *params,
+                 int32_t current_ma, int32_t speed_rpm, int32_t duty) {
+    if (motor >= MOTOR_COUNT || stalls[motor].state != STALL_STATE_OK) {
+        return false;
+    }
+    Stall_t *s = &stalls[motor];
+
+    if (current_ma < 0) {
+        current_ma = -current_ma;
+    }
+    if (speed_rpm < 0) {
+        speed_rpm = -speed_rpm;
+    }
+    if (duty < 0) {
+        duty = -duty;
+    }
+
+    // duty_pm / 1000 * PWM_DUTY_MAX, so sanh khong chia
+    if (current_ma < params->current_ma || speed_rpm > params->speed_rpm ||
+        duty * 1000 < (int32_t)params->duty_pm * PWM_DUTY_MAX) {
+        s->stall_ticks = 0;
+        if (s->clear_ticks < CONFIG_STALL_RETRY_RESET_MS) {
+            s->clear_ticks++;
+        } else {
+            s->retries = 0;
+        }
+        return false;
+    }
+
+    s->clear_ticks = 0;
+    if (++s->stall_ticks < params->time_ms) {
+        return false;
+    }
+    s->stall_ticks = 0;
+    s->state = STALL_STATE_STALLED;
+    if (s->count < UINT16_MAX) {
+        s->count++;
+    }
+    return true;
+}
+
+void Stall_StartBackoff(uint8_t motor, const Stall_Params_t *params) {
+    if (motor >= MOTOR_COUNT) {
+        return;
+    }
+    Stall_t *s = &stalls[motor];
+    uint16_t shift = (s->retries < CONFIG_STALL_BACKOFF_SHIFT) ? s->retries : CONFIG_STALL_BACKOFF_SHIFT;
+
+    if (s->retries >= params->retry_max) {
+        s->state = STALL_STATE_STALLED;
+        return;
+    }
+    s->backoff_ticks = (uint32_t)params->retry_delay_ms << shift;
+    s->state = STALL_STATE_BACKOFF;
+}
+
+bool Stall_Latch(uint8_t motor, uint16_t *error) {
+    if (motor >= MOTOR_COUNT) {
+        return false;
+    }
+    // ISR qua dong ghi cung register: kiem tra va ghi khong bi chen
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool latched = (*error == MOTOR_ERR_NONE);
+    if (latched) {
+        *error = MOTOR_ERR_STALL;
+    }
+    __set_PRIMASK(primask);
+
+    if (!latched) {
+        Stall_Reset(motor);
+    }
+    return latched;
+}
+
+bool Stall_RetryDue(uint8_t motor, uint16_t *error, bool ocp_tripped) {
+    if (motor >= MOTOR_COUNT || stalls[motor].state != STALL_STATE_BACKOFF) {
+        return false;
+    }
+    Stall_t *s = &stalls[motor];
+
+    if (s->backoff_ticks > 0U) {
+        s->backoff_ticks--;
+        return false;
+    }
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    bool retry = (*error == MOTOR_ERR_STALL && !ocp_tripped);
+    if (retry) {
+        *error = MOTOR_ERR_NONE;
+    }
+    __set_PRIMASK(primask);
+
+    if (!retry) {
+        Stall_Reset(motor);             // loi khac da chiem: cho master reset
+        return false;
+    }
+    s->retries++;
+    s->clear_ticks = 0;
+    s->state = STALL_STATE_OK;
+    return true;
+}
+
+Stall_State_t Stall_GetState(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? stalls[motor].state : STALL_STATE_OK;
+}
+
+uint16_t Stall_GetCount(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? stalls[motor].count : 0U;
+}
+
+uint16_t Stall_GetRetries(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? stalls[motor].retries : 0U;
+}
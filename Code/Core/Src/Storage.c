@@ -0,0 +1,132 @@
+/*
+ * Storage.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Storage.h"
+#include "main.h"
+#include "Config.h"
+#include "ModbusMap.h"
+#include "modbus_crc.h"
+
+#define STORAGE_MAGIC           0x50434444UL    // "DDCP"
+#define STORAGE_HEADER_SIZE     8U              // magic (4) + word count (2) + CRC (2)
+#define STORAGE_MAX_WORDS       256U
+
+typedef struct {
+    uint16_t address;
+    uint16_t count;
+} Storage_Range_t;
+
+// Register duoc luu; doi bang nay lam anh cu khong hop le (so word khac)
+static const Storage_Range_t storage_ranges[] = {
+    { REG_M1_PID_KP,      3 },  // Kp, Ki, Kd
+    { REG_M2_PID_KP,      3 },
+    { REG_M1_CURRENT_KP,  3 },  // Kp, Ki, limit
+    { REG_M2_CURRENT_KP,  3 },
+    { REG_M1_ENCODER_PPR, 1 },
+    { REG_M2_ENCODER_PPR, 1 },
+    { REG_M1_MOTOR_R,     3 },  // R, L, Ke
+    { REG_M2_MOTOR_R,     3 },
+    { REG_M1_MOTOR_J,     3 },  // J, Fv, Fc
+    { REG_M2_MOTOR_J,     3 },
+    { REG_M1_ACCEL_LIMIT, 9 },  // accel, decel, Kv, Ka, static, stop mode, stop decel, regen, brake
+    { REG_M2_ACCEL_LIMIT, 9 },
+    { REG_VBUS_MV,        1 },
+    { REG_PWM_OUTPUT_MODE, 2 }, // output mode, dead-time
+    { REG_M1_SCHED_SOURCE, 2 }, // source, count
+    { REG_M2_SCHED_SOURCE, 2 },
+    { REG_M1_SCHED_TABLE, GAIN_SCHED_MAX_POINTS * 4U },
+    { REG_M2_SCHED_TABLE, GAIN_SCHED_MAX_POINTS * 4U },
+    { REG_M1_MOVE_VMAX,   2 },  // vmax, accel
+    { REG_M2_MOVE_VMAX,   2 },
+    { REG_M1_POS_KP,      2 },  // Kp, in-position window
+    { REG_M2_POS_KP,      2 },
+    { REG_GEAR_SOURCE,    6 },  // source, ratio, offset, Kc
+    { REG_DRIVE_WHEEL_BASE, 5 },// base, radius, max RPM, accel, alpha
+    { REG_M1_THERMAL_RATED, 3 },// rated current, tau, horizon
+    { REG_M2_THERMAL_RATED, 3 },
+    { REG_M1_STALL_REACTION, 8 },// reaction, thresholds, reduce, retry
+    { REG_M2_STALL_REACTION, 8 },
+    { REG_M1_LIN_ENABLE,  2 },  // enable, dead band
+    { REG_M2_LIN_ENABLE,  2 },
+    { REG_M1_LIN_TABLE,   LINEAR_LUT_POINTS },
+    { REG_M2_LIN_TABLE,   LINEAR_LUT_POINTS },
+    { REG_M1_ONOFF_SOURCE, 3 }, // source, pin, polarity
+    { REG_M2_ONOFF_SOURCE, 3 },
+    { REG_M1_ONOFF_ON_LEVEL, 6 },// levels, duty, soft-start, min on / off
+    { REG_M2_ONOFF_ON_LEVEL, 6 },
+    { REG_PROX_SOURCE,    3 },  // source, pin, polarity
+    { REG_PROX_TIMEOUT,   6 },  // timeout, motors, guard, safe, slow, creep
+    { REG_PWM_MIN_PULSE,  2 },  // min pulse, dither
+};
+
+#define STORAGE_RANGE_COUNT     (sizeof(storage_ranges) / sizeof(storage_ranges[0]))
+
+static uint16_t * const registers = (uint16_t *)&g_modbus_data;
+
+static uint16_t Storage_WordCount(void) {
+    uint16_t words = 0;
+    for (uint32_t i = 0; i < STORAGE_RANGE_COUNT; i++) {
+        words += storage_ranges[i].count;
+    }
+    return words;
+}
+
+void Storage_Load(void) {
+    const uint32_t *magic = (const uint32_t *)CONFIG_STORAGE_FLASH_ADDR;
+    const uint16_t *header = (const uint16_t *)(CONFIG_STORAGE_FLASH_ADDR + 4U);
+    const uint16_t *values = (const uint16_t *)(CONFIG_STORAGE_FLASH_ADDR + STORAGE_HEADER_SIZE);
+    uint16_t words = Storage_WordCount();
+
+    if (*magic != STORAGE_MAGIC || header[0] != words ||
+        header[1] != modbus_crc16((const uint8_t *)values, (uint16_t)(words * 2U))) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < STORAGE_RANGE_COUNT; i++) {
+        for (uint16_t j = 0; j < storage_ranges[i].count; j++) {
+            registers[storage_ranges[i].address + j] = *values++;
+        }
+    }
+}
+
+bool Storage_Save(void) {
+    FLASH_EraseInitTypeDef erase = {
+        .TypeErase = FLASH_TYPEERASE_PAGES,
+        .PageAddress = CONFIG_STORAGE_FLASH_ADDR,
+        .NbPages = 1,
+    };
+    static uint16_t image[STORAGE_MAX_WORDS];   // ngoai stack task (256 word)
+    uint16_t words = Storage_WordCount();
+    uint32_t page_error = 0;
+    uint32_t addr = CONFIG_STORAGE_FLASH_ADDR + STORAGE_HEADER_SIZE;
+    uint16_t n = 0;
+    bool ok;
+
+    if (words > STORAGE_MAX_WORDS) {
+        return false;
+    }
+    for (uint32_t i = 0; i < STORAGE_RANGE_COUNT; i++) {
+        for (uint16_t j = 0; j < storage_ranges[i].count; j++) {
+            image[n++] = registers[storage_ranges[i].address + j];
+        }
+    }
+
+    HAL_FLASH_Unlock();
+    ok = (HAL_FLASHEx_Erase(&erase, &page_error) == HAL_OK);
+    for (uint16_t i = 0; ok && i < words; i++, addr += 2U) {
+        ok = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, addr, image[i]) == HAL_OK);
+    }
+    // Header ghi sau cung: mat dien giua chung -> magic van la 0xFFFFFFFF
+    if (ok) {
+        ok = (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, CONFIG_STORAGE_FLASH_ADDR + 4U, words) == HAL_OK) &&
+             (HAL_FLASH_Program(FLASH_TYPEPROGRAM_HALFWORD, CONFIG_STORAGE_FLASH_ADDR + 6U,
+                                modbus_crc16((const uint8_t *)image, (uint16_t)(words * 2U))) == HAL_OK) &&
+             (HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, CONFIG_STORAGE_FLASH_ADDR, STORAGE_MAGIC) == HAL_OK);
+    }
+    HAL_FLASH_Lock();
+    return ok;
+}
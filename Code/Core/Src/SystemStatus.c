@@ -5,4 +5,70 @@
  *      Author: ASUS
  */
 
+#include "SystemStatus.h"
+#include "ModbusMap.h"
+#include "PWM.h"
+#include "Timing.h"
+#include "CurrentSense.h"
+#include "Protection.h"
+#include "Storage.h"
+#include "MotorDC.h"
+#include "MotorIdent.h"
 
+static void SystemStatus_PublishPwm(void) {
+    g_modbus_data.pwm_freq_khz = (uint16_t)(PWM_GetFrequency() / 1000U);
+    g_modbus_data.pwm_align = (uint16_t)PWM_GetAlign();
+    g_modbus_data.pwm_resolution = PWM_GetResolution();
+    g_modbus_data.pwm_output = (uint16_t)PWM_GetOutputMode();
+    g_modbus_data.pwm_dead_time_ns = PWM_GetDeadTime();
+    g_modbus_data.pwm_post.min_pulse_ns = PWM_GetMinPulse();
+    g_modbus_data.pwm_post.dither = PWM_GetDither() ? 1U : 0U;
+    g_modbus_data.pwm_post.min_duty_pm = PWM_GetMinDuty();
+}
+
+void SystemStatus_Init(void) {
+    g_modbus_data.sysclk_mhz = (uint16_t)(Timing_GetSysClockHz() / 1000000U);
+    // Gia tri nap tu flash (Storage_Load), khong hop le thi giu mac dinh
+    PWM_SetOutputMode((PWM_OutputMode_t)g_modbus_data.pwm_output, g_modbus_data.pwm_dead_time_ns);
+    PWM_SetPostProcess(g_modbus_data.pwm_post.min_pulse_ns, g_modbus_data.pwm_post.dither != 0U);
+    SystemStatus_PublishPwm();
+}
+
+void SystemStatus_Update(void) {
+    uint32_t freq_hz = (uint32_t)g_modbus_data.pwm_freq_khz * 1000U;
+    PWM_Align_t align = (PWM_Align_t)g_modbus_data.pwm_align;
+
+    if (freq_hz != PWM_GetFrequency() || align != PWM_GetAlign()) {
+        // PWM_Configure() tu choi gia tri ngoai gioi han, publish lai cau hinh dang chay
+        if (PWM_Configure(freq_hz, align)) {
+            CurrentSense_Reconfigure();     // decimation = PWM / CONFIG_CURRENT_LOOP_HZ
+        }
+        SystemStatus_PublishPwm();
+    }
+
+    // Dead-time doc lai da lam tron len theo buoc DTG nen chi ap dung lai khi master ghi
+    if (g_modbus_data.pwm_output != (uint16_t)PWM_GetOutputMode() ||
+        g_modbus_data.pwm_dead_time_ns != PWM_GetDeadTime()) {
+        PWM_SetOutputMode((PWM_OutputMode_t)g_modbus_data.pwm_output, g_modbus_data.pwm_dead_time_ns);
+        SystemStatus_PublishPwm();
+    }
+
+    if (g_modbus_data.pwm_post.min_pulse_ns != PWM_GetMinPulse() ||
+        (g_modbus_data.pwm_post.dither != 0U) != PWM_GetDither()) {
+        PWM_SetPostProcess(g_modbus_data.pwm_post.min_pulse_ns, g_modbus_data.pwm_post.dither != 0U);
+        SystemStatus_PublishPwm();
+    }
+
+    Protection_Update();
+
+    if (g_modbus_data.param_save == PARAM_SAVE_REQUEST) {
+        // Xoa trang flash dung CPU ~20-40 ms: chi khi moi motor dang tat
+        bool idle = !driver.motor1._enabled && !driver.motor2._enabled &&
+                    MotorIdent_GetState(0) != IDENT_STEP && MotorIdent_GetState(0) != IDENT_RAMP &&
+                    MotorIdent_GetState(1) != IDENT_STEP && MotorIdent_GetState(1) != IDENT_RAMP;
+        g_modbus_data.param_save = (idle && Storage_Save()) ? PARAM_SAVE_IDLE : PARAM_SAVE_FAILED;
+    }
+
+    g_modbus_data.m1.current_ma = CurrentSense_GetMilliAmps(0);
+    g_modbus_data.m2.current_ma = CurrentSense_GetMilliAmps(1);
+}
@@ -0,0 +1,146 @@
+/*
+ * Thermal.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Thermal.h"
+#include "main.h"
+#include "Config.h"
+#include "FixedPoint.h"
+
+typedef struct {
+    uint32_t rated_sq;          // I_rated^2 (mA^2), 0 = tat
+    uint32_t tau_ms;
+    uint32_t k_q32;             // dt / tau, Q32
+    volatile int64_t heat_q16;  // I^2 da loc (mA^2, Q16), chi ISR ghi
+} Thermal_Model_t;
+
+typedef struct {
+    Thermal_Params_t params;    // thong so da nap (phat hien thay doi)
+    uint32_t loop_hz;
+    Thermal_Model_t motor;
+    Thermal_Model_t bridge;
+} Thermal_t;
+
+static Thermal_t models[MOTOR_COUNT];
+
+static void Thermal_SetModel(Thermal_Model_t *model, uint32_t rated_ma, uint32_t tau_ms,
+                             uint32_t loop_hz) {
+    uint64_t ticks = (uint64_t)tau_ms * loop_hz;
+
+    if (ticks < 2000U) {
+        ticks = 2000U;                          // tau >= 2 tick: k < 1 (Q32)
+    }
+    model->rated_sq = rated_ma * rated_ma;
+    model->tau_ms = tau_ms;
+    model->k_q32 = (uint32_t)((1000ULL << 32) / ticks);
+}
+
+void Thermal_Configure(uint8_t motor, const Thermal_Params_t *params, uint32_t loop_hz) {
+    if (motor >= MOTOR_COUNT || loop_hz == 0U) {
+        return;
+    }
+    Thermal_t *t = &models[motor];
+    if (t->loop_hz == loop_hz && t->params.motor_rated_ma == params->motor_rated_ma &&
+        t->params.motor_tau_s == params->motor_tau_s && t->params.horizon_ms == params->horizon_ms) {
+        return;
+    }
+
+    // Giu nguyen heat: doi thong so khong lam motor "nguoi" lai
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    t->params = *params;
+    t->loop_hz = loop_hz;
+    // tau = 0: khong co mo hinh (neu khong, tau*1000/horizon = 0 cat dong ve sqrt(heat))
+    Thermal_SetModel(&t->motor, (params->motor_tau_s != 0U) ? params->motor_rated_ma : 0U,
+                     params->motor_tau_s * 1000UL, loop_hz);
+    Thermal_SetModel(&t->bridge, CONFIG_BRIDGE_RATED_MA, CONFIG_BRIDGE_TAU_MS, loop_hz);
+    __set_PRIMASK(primask);
+}
+
+static void Thermal_Step(Thermal_Model_t *model, uint32_t current_sq) {
+    int64_t delta = ((int64_t)current_sq << 16) - model->heat_q16;
+
+    // |delta >> 16| < 2^30, k < 2^32 / (tau * loop_hz): tich khong tran int64
+    model->heat_q16 += ((delta >> 16) * model->k_q32) >> 16;
+}
+
+void Thermal_Update(uint8_t motor, int32_t current_ma) {
+    if (motor >= MOTOR_COUNT || models[motor].loop_hz == 0U) {
+        return;
+    }
+    if (current_ma < 0) {
+        current_ma = -current_ma;
+    }
+    uint32_t current_sq = (uint32_t)current_ma * (uint32_t)current_ma;
+
+    Thermal_Step(&models[motor].bridge, current_sq);
+    if (models[motor].motor.rated_sq != 0U) {
+        Thermal_Step(&models[motor].motor, current_sq);
+    }
+}
+
+static uint32_t Thermal_GetHeat(const Thermal_Model_t *model) {
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    int64_t heat = model->heat_q16;
+    __set_PRIMASK(primask);
+
+    return (heat > 0) ? (uint32_t)(heat >> 16) : 0U;
+}
+
+static uint16_t Thermal_Percent(const Thermal_Model_t *model) {
+    uint64_t pct;
+
+    if (model->rated_sq == 0U) {
+        return 0;
+    }
+    pct = ((uint64_t)Thermal_GetHeat(model) * 100U) / model->rated_sq;
+    return (pct > UINT16_MAX) ? UINT16_MAX : (uint16_t)pct;
+}
+
+// Dong lon nhat giu heat <= rated_sq sau horizon (xap xi bac 1)
+static uint32_t Thermal_Allowed(const Thermal_Model_t *model, uint32_t horizon_ms) {
+    int64_t heat = Thermal_GetHeat(model);
+    int64_t allowed_sq = heat + ((int64_t)model->rated_sq - heat) * model->tau_ms / horizon_ms;
+
+    if (allowed_sq <= 0) {
+        return 0;
+    }
+    return FP_Sqrt((allowed_sq > UINT32_MAX) ? UINT32_MAX : (uint32_t)allowed_sq);
+}
+
+uint16_t Thermal_GetAllowedCurrent(uint8_t motor) {
+    uint32_t allowed = CONFIG_BRIDGE_PEAK_MA;
+    uint32_t m;
+
+    if (motor >= MOTOR_COUNT) {
+        return 0;
+    }
+    Thermal_t *t = &models[motor];
+    if (t->loop_hz == 0U || t->params.horizon_ms == 0U) {
+        return (uint16_t)allowed;
+    }
+
+    m = Thermal_Allowed(&t->bridge, t->params.horizon_ms);
+    if (m < allowed) {
+        allowed = m;
+    }
+    if (t->motor.rated_sq != 0U) {
+        m = Thermal_Allowed(&t->motor, t->params.horizon_ms);
+        if (m < allowed) {
+            allowed = m;
+        }
+    }
+    return (uint16_t)allowed;
+}
+
+uint16_t Thermal_GetMotorPercent(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? Thermal_Percent(&models[motor].motor) : 0U;
+}
+
+uint16_t Thermal_GetBridgePercent(uint8_t motor) {
+    return (motor < MOTOR_COUNT) ? Thermal_Percent(&models[motor].bridge) : 0U;
+}
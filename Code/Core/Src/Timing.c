@@ -0,0 +1,99 @@
+/*
+ * Timing.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#include "Timing.h"
+#include "Config.h"
+
+Timing_t g_timing;
+
+void Timing_SelectClockProfile(void) {
+#if (CONFIG_SYSCLK_PROFILE == CONFIG_SYSCLK_PROFILE_72MHZ_HSE)
+    RCC_OscInitTypeDef osc = {0};
+    RCC_ClkInitTypeDef clk = {0};
+
+    // PLL khong cau hinh lai duoc khi dang la SYSCLK: tam chay tu HSI
+    clk.ClockType = RCC_CLOCKTYPE_SYSCLK;
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+    if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_2) != HAL_OK) {
+        Error_Handler();
+    }
+
+    osc.OscillatorType = RCC_OSCILLATORTYPE_HSE;
+    osc.HSEState = RCC_HSE_ON;
+    osc.HSEPredivValue = RCC_HSE_PREDIV_DIV1;
+    osc.PLL.PLLState = RCC_PLL_ON;
+    osc.PLL.PLLSource = RCC_PLLSOURCE_HSE;
+    osc.PLL.PLLMUL = RCC_PLL_MUL9;
+    if (HAL_RCC_OscConfig(&osc) != HAL_OK) {
+        // HSE khong len: ve lai HSI/2 x16 = 64 MHz nhu SystemClock_Config()
+        osc.HSEState = RCC_HSE_OFF;
+        osc.PLL.PLLSource = RCC_PLLSOURCE_HSI_DIV2;
+        osc.PLL.PLLMUL = RCC_PLL_MUL16;
+        if (HAL_RCC_OscConfig(&osc) != HAL_OK) {
+            Error_Handler();
+        }
+    }
+
+    clk.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
+    if (HAL_RCC_ClockConfig(&clk, FLASH_LATENCY_2) != HAL_OK) {
+        Error_Handler();
+    }
+#endif
+}
+
+void Timing_Init(void) {
+    g_timing.sysclk_hz = HAL_RCC_GetSysClockFreq();
+    g_timing.hclk_hz   = HAL_RCC_GetHCLKFreq();
+    g_timing.pclk1_hz  = HAL_RCC_GetPCLK1Freq();
+    g_timing.pclk2_hz  = HAL_RCC_GetPCLK2Freq();
+
+    // Timer kernel clock = PCLKx neu APB prescaler = 1, nguoc lai 2 x PCLKx
+    g_timing.tim_apb1_hz = (READ_BIT(RCC->CFGR, RCC_CFGR_PPRE1) == RCC_CFGR_PPRE1_DIV1)
+                         ? g_timing.pclk1_hz : 2U * g_timing.pclk1_hz;
+    g_timing.tim_apb2_hz = (READ_BIT(RCC->CFGR, RCC_CFGR_PPRE2) == RCC_CFGR_PPRE2_DIV1)
+                         ? g_timing.pclk2_hz : 2U * g_timing.pclk2_hz;
+
+    g_timing.current_loop_div = Timing_GetLoopDivider(CONFIG_PWM_FREQUENCY_HZ, CONFIG_CURRENT_LOOP_HZ);
+    g_timing.control_loop_div = Timing_GetLoopDivider(CONFIG_CURRENT_LOOP_HZ, CONFIG_CONTROL_LOOP_HZ);
+}
+
+uint32_t Timing_GetLoopDivider(uint32_t base_hz, uint32_t loop_hz) {
+    uint32_t div = (loop_hz != 0) ? base_hz / loop_hz : 1U;
+    return (div == 0) ? 1U : div;
+}
+
+uint32_t Timing_GetSysClockHz(void) {
+    return g_timing.sysclk_hz;
+}
+
+uint32_t Timing_GetTimerClockHz(const TIM_TypeDef *tim) {
+    // TIM1 nam tren APB2, cac timer con lai tren APB1
+    return (tim == TIM1) ? g_timing.tim_apb2_hz : g_timing.tim_apb1_hz;
+}
+
+uint32_t Timing_GetPwmPeriod(const TIM_TypeDef *tim, uint32_t freq_hz) {
+    if (freq_hz == 0) {
+        return 0xFFFF;
+    }
+    uint32_t ticks = (Timing_GetTimerClockHz(tim) + freq_hz / 2U) / freq_hz;
+    if (ticks > 0x10000U) {
+        ticks = 0x10000U;
+    }
+    return (ticks > 1U) ? ticks - 1U : 1U;
+}
+
+uint32_t Timing_GetMicrosecondPrescaler(const TIM_TypeDef *tim) {
+    return Timing_GetTimerClockHz(tim) / 1000000U - 1U;
+}
+
+uint32_t Timing_GetModbusT35Us(uint32_t baudrate) {
+    if (baudrate == 0 || baudrate > 19200U) {
+        return 1750U;
+    }
+    // 3.5 char * 11 bit = 38.5 bit, lam tron len
+    return (38500000U + baudrate - 1U) / baudrate;
+}
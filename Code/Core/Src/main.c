@@ -23,6 +23,16 @@
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
 #include "modbus.h"
+#include "Config.h"
+#include "Timing.h"
+#include "ModbusMap.h"
+#include "PWM.h"
+#include "CurrentSense.h"
+#include "SystemStatus.h"
+#include "Protection.h"
+#include "MotorDC.h"
+#include "Encoder.h"
+#include "Storage.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -61,14 +71,14 @@ const osThreadAttr_t defaultTask_attributes = {
 osThreadId_t Motor1_TaskHandle;
 const osThreadAttr_t Motor1_Task_attributes = {
   .name = "Motor1_Task",
-  .stack_size = 128 * 4,
+  .stack_size = 256 * 4,
   .priority = (osPriority_t) osPriorityBelowNormal,
 };
 /* Definitions for Motor2_Task */
 osThreadId_t Motor2_TaskHandle;
 const osThreadAttr_t Motor2_Task_attributes = {
   .name = "Motor2_Task",
-  .stack_size = 128 * 4,
+  .stack_size = 256 * 4,
   .priority = (osPriority_t) osPriorityBelowNormal2,
 };
 /* Definitions for Modbus_Task */
@@ -129,6 +139,8 @@ int main(void)
   SystemClock_Config();
 
   /* USER CODE BEGIN SysInit */
+  Timing_SelectClockProfile();
+  Timing_Init();
 
   /* USER CODE END SysInit */
 
@@ -141,6 +153,13 @@ int main(void)
   MX_I2C1_Init();
   MX_TIM2_Init();
   /* USER CODE BEGIN 2 */
+  Storage_Load();
+  PWM_Init();
+  CurrentSense_Init();
+  Protection_Init();
+  SystemStatus_Init();
+  Encoder_Init();
+  _motorInit();
 
   /* USER CODE END 2 */
 
@@ -215,7 +234,9 @@ void SystemClock_Config(void)
   RCC_OscInitStruct.OscillatorType = RCC_OSCILLATORTYPE_HSI;
   RCC_OscInitStruct.HSIState = RCC_HSI_ON;
   RCC_OscInitStruct.HSICalibrationValue = RCC_HSICALIBRATION_DEFAULT;
-  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_NONE;
+  RCC_OscInitStruct.PLL.PLLState = RCC_PLL_ON;
+  RCC_OscInitStruct.PLL.PLLSource = RCC_PLLSOURCE_HSI_DIV2;
+  RCC_OscInitStruct.PLL.PLLMUL = RCC_PLL_MUL16;
   if (HAL_RCC_OscConfig(&RCC_OscInitStruct) != HAL_OK)
   {
     Error_Handler();
@@ -225,12 +246,12 @@ void SystemClock_Config(void)
   */
   RCC_ClkInitStruct.ClockType = RCC_CLOCKTYPE_HCLK|RCC_CLOCKTYPE_SYSCLK
                               |RCC_CLOCKTYPE_PCLK1|RCC_CLOCKTYPE_PCLK2;
-  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_HSI;
+  RCC_ClkInitStruct.SYSCLKSource = RCC_SYSCLKSOURCE_PLLCLK;
   RCC_ClkInitStruct.AHBCLKDivider = RCC_SYSCLK_DIV1;
-  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV1;
+  RCC_ClkInitStruct.APB1CLKDivider = RCC_HCLK_DIV2;
   RCC_ClkInitStruct.APB2CLKDivider = RCC_HCLK_DIV1;
 
-  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_0) != HAL_OK)
+  if (HAL_RCC_ClockConfig(&RCC_ClkInitStruct, FLASH_LATENCY_2) != HAL_OK)
   {
     Error_Handler();
   }
@@ -292,16 +313,16 @@ static void MX_TIM1_Init(void)
   htim1.Instance = TIM1;
   htim1.Init.Prescaler = 0;
   htim1.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim1.Init.Period = 65535;
+  htim1.Init.Period = 3199;
   htim1.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim1.Init.RepetitionCounter = 0;
-  htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  htim1.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
   if (HAL_TIM_PWM_Init(&htim1) != HAL_OK)
   {
     Error_Handler();
   }
-  sMasterConfig.MasterOutputTrigger = TIM_TRGO_RESET;
-  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_DISABLE;
+  sMasterConfig.MasterOutputTrigger = TIM_TRGO_ENABLE;    // start TIM3 (slave) in phase
+  sMasterConfig.MasterSlaveMode = TIM_MASTERSLAVEMODE_ENABLE;
   if (HAL_TIMEx_MasterConfigSynchronization(&htim1, &sMasterConfig) != HAL_OK)
   {
     Error_Handler();
@@ -318,7 +339,7 @@ static void MX_TIM1_Init(void)
     Error_Handler();
   }
   sBreakDeadTimeConfig.OffStateRunMode = TIM_OSSR_DISABLE;
-  sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_DISABLE;
+  sBreakDeadTimeConfig.OffStateIDLEMode = TIM_OSSI_ENABLE;
   sBreakDeadTimeConfig.LockLevel = TIM_LOCKLEVEL_OFF;
   sBreakDeadTimeConfig.DeadTime = 0;
   sBreakDeadTimeConfig.BreakState = TIM_BREAK_DISABLE;
@@ -329,6 +350,11 @@ static void MX_TIM1_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM1_Init 2 */
+  htim1.Init.Period = Timing_GetPwmPeriod(TIM1, CONFIG_PWM_FREQUENCY_HZ);
+  if (HAL_TIM_PWM_Init(&htim1) != HAL_OK)
+  {
+    Error_Handler();
+  }
 
   /* USER CODE END TIM1_Init 2 */
   HAL_TIM_MspPostInit(&htim1);
@@ -354,9 +380,9 @@ static void MX_TIM2_Init(void)
 
   /* USER CODE END TIM2_Init 1 */
   htim2.Instance = TIM2;
-  htim2.Init.Prescaler = 71;  // FIXED: 72MHz/72 = 1MHz timer clock
+  htim2.Init.Prescaler = 63;
   htim2.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim2.Init.Period = 4000;   // FIXED: 4ms timeout for Modbus (3.5 char time @ 9600 baud)
+  htim2.Init.Period = 4011;
   htim2.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
   htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
   if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
@@ -375,6 +401,12 @@ static void MX_TIM2_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM2_Init 2 */
+  htim2.Init.Prescaler = Timing_GetMicrosecondPrescaler(TIM2);  // 1 MHz timer clock
+  htim2.Init.Period = Timing_GetModbusT35Us(CONFIG_MODBUS_BAUDRATE);  // t3.5 frame timeout
+  if (HAL_TIM_Base_Init(&htim2) != HAL_OK)
+  {
+    Error_Handler();
+  }
 
   /* USER CODE END TIM2_Init 2 */
 
@@ -401,9 +433,9 @@ static void MX_TIM3_Init(void)
   htim3.Instance = TIM3;
   htim3.Init.Prescaler = 0;
   htim3.Init.CounterMode = TIM_COUNTERMODE_UP;
-  htim3.Init.Period = 65535;
+  htim3.Init.Period = 3199;
   htim3.Init.ClockDivision = TIM_CLOCKDIVISION_DIV1;
-  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+  htim3.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
   if (HAL_TIM_PWM_Init(&htim3) != HAL_OK)
   {
     Error_Handler();
@@ -423,6 +455,11 @@ static void MX_TIM3_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN TIM3_Init 2 */
+  htim3.Init.Period = Timing_GetPwmPeriod(TIM3, CONFIG_PWM_FREQUENCY_HZ);
+  if (HAL_TIM_PWM_Init(&htim3) != HAL_OK)
+  {
+    Error_Handler();
+  }
 
   /* USER CODE END TIM3_Init 2 */
   HAL_TIM_MspPostInit(&htim3);
@@ -449,7 +486,7 @@ static void MX_USART1_UART_Init(void)
   huart1.Init.WordLength = UART_WORDLENGTH_8B;
   huart1.Init.StopBits = UART_STOPBITS_1;
   huart1.Init.Parity = UART_PARITY_NONE;
-  huart1.Init.Mode = UART_MODE_TX_RX;
+  huart1.Init.Mode = UART_MODE_RX;
   huart1.Init.HwFlowCtl = UART_HWCONTROL_NONE;
   huart1.Init.OverSampling = UART_OVERSAMPLING_16;
   if (HAL_UART_Init(&huart1) != HAL_OK)
@@ -490,6 +527,14 @@ static void MX_USART2_UART_Init(void)
     Error_Handler();
   }
   /* USER CODE BEGIN USART2_Init 2 */
+  if (huart2.Init.BaudRate != CONFIG_MODBUS_BAUDRATE)
+  {
+    huart2.Init.BaudRate = CONFIG_MODBUS_BAUDRATE;
+    if (HAL_UART_Init(&huart2) != HAL_OK)
+    {
+      Error_Handler();
+    }
+  }
 
   /* USER CODE END USART2_Init 2 */
 
@@ -528,11 +573,6 @@ static void MX_GPIO_Init(void)
   GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
   HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
 
-  /*Configure GPIO pin : CUR_SENS_Pin */
-  GPIO_InitStruct.Pin = CUR_SENS_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_ANALOG;
-  HAL_GPIO_Init(CUR_SENS_GPIO_Port, &GPIO_InitStruct);
-
   /*Configure GPIO pins : LED1_Pin DIR2_Pin DIR3_Pin */
   GPIO_InitStruct.Pin = LED1_Pin|DIR2_Pin|DIR3_Pin;
   GPIO_InitStruct.Mode = GPIO_MODE_OUTPUT_PP;
@@ -542,7 +582,7 @@ static void MX_GPIO_Init(void)
 
   /*Configure GPIO pins : IN1_Pin IN2_Pin IN3_Pin */
   GPIO_InitStruct.Pin = IN1_Pin|IN2_Pin|IN3_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
@@ -555,7 +595,7 @@ static void MX_GPIO_Init(void)
 
   /*Configure GPIO pin : IN4_Pin */
   GPIO_InitStruct.Pin = IN4_Pin;
-  GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+  GPIO_InitStruct.Mode = GPIO_MODE_IT_RISING_FALLING;
   GPIO_InitStruct.Pull = GPIO_NOPULL;
   HAL_GPIO_Init(IN4_GPIO_Port, &GPIO_InitStruct);
 
@@ -581,6 +621,7 @@ void StartDefaultTask(void *argument)
   /* Infinite loop */
   for(;;)
   {
+    SystemStatus_Update();
     osDelay(1);
   }
   /* USER CODE END 5 */
@@ -596,10 +637,13 @@ void StartDefaultTask(void *argument)
 void StartTask02(void *argument)
 {
   /* USER CODE BEGIN StartTask02 */
+  uint32_t tick = osKernelGetTickCount();
   /* Infinite loop */
   for(;;)
   {
-    osDelay(1);
+    _updateMotor(&driver.motor1);
+    tick += 1;    // CONFIG_CONTROL_LOOP_HZ = 1 RTOS tick
+    osDelayUntil(tick);
   }
   /* USER CODE END StartTask02 */
 }
@@ -614,10 +658,13 @@ void StartTask02(void *argument)
 void StartTask03(void *argument)
 {
   /* USER CODE BEGIN StartTask03 */
+  uint32_t tick = osKernelGetTickCount();
   /* Infinite loop */
   for(;;)
   {
-    osDelay(1);
+    _updateMotor(&driver.motor2);
+    tick += 1;    // CONFIG_CONTROL_LOOP_HZ = 1 RTOS tick
+    osDelayUntil(tick);
   }
   /* USER CODE END StartTask03 */
 }
@@ -632,122 +679,21 @@ void StartTask03(void *argument)
 void StartTask04(void *argument)
 {
   /* USER CODE BEGIN StartTask04 */
-  
-  // Debug: Blink LED1 ngay khi task bắt đầu
-  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-  osDelay(100);
-  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-  
-  // Debug: Blink LED2 để test GPIO
-  HAL_GPIO_TogglePin(LED2_GPIO_Port, LED2_Pin);
-  osDelay(100);
-  HAL_GPIO_TogglePin(LED2_GPIO_Port, LED2_Pin);
-  
-  // Debug: Blink LED3 để test GPIO
-  HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-  osDelay(100);
-  HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-  
-  // Debug: Blink LED4 để test GPIO
-  HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
-  osDelay(100);
-  HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
-  
-  // Initialize Modbus
+  uint32_t tick;
+
   modbus_init();
-  
-  // Debug: Blink LED1 sau khi modbus_init() thành công
-  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-  osDelay(300);
-  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-  
-  // Debug: LED indicators for modbus status
-  uint32_t modbus_heartbeat = 0;
-  uint32_t test_counter = 0;
-  uint32_t uart_receive_count = 0;
-  
-  // Set some test data in registers for debugging
-  modbus_write_register(0x0000, 50);   // Motor 1 Target Speed = 50%
-  modbus_write_register(0x0001, 45);   // Motor 1 Current Speed = 45%
-  modbus_write_register(0x0002, 1);    // Motor 1 Direction = Forward
-  modbus_write_register(0x0003, 100);  // Motor 1 Kp = 1.00
-  modbus_write_register(0x0004, 50);   // Motor 1 Ki = 0.50
-  modbus_write_register(0x0005, 25);   // Motor 1 Kd = 0.25
-  
-  modbus_write_register(0x0010, 60);   // Motor 2 Target Speed = 60%
-  modbus_write_register(0x0011, 55);   // Motor 2 Current Speed = 55%
-  modbus_write_register(0x0012, 0);    // Motor 2 Direction = Reverse
-  modbus_write_register(0x0013, 120);  // Motor 2 Kp = 1.20
-  modbus_write_register(0x0014, 60);   // Motor 2 Ki = 0.60
-  modbus_write_register(0x0015, 30);   // Motor 2 Kd = 0.30
-  
-  // System registers - FIXED: Updated to correct addresses
-  modbus_write_register(0x0020, 0x1234); // Device ID
-  modbus_write_register(0x0021, 0x0100); // Firmware Version 1.0
-  modbus_write_register(0x0022, 0x0001); // System Status = OK
-  modbus_write_register(0x0023, 0x0000); // Error Code = No Error
-  
-  // Debug: Blink LED1 to show modbus is initialized
-  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-  osDelay(500);
-  HAL_GPIO_TogglePin(LED1_GPIO_Port, LED1_Pin);
-  
+
+  modbus_write_register(REG_SYSTEM_ERROR, 0x0000);   // Error Code = No Error
+
+  tick = osKernelGetTickCount();
   /* Infinite loop */
   for(;;)
   {
-    // Debug: Heartbeat LED every 1 second
-    modbus_heartbeat++;
-    if (modbus_heartbeat >= 1000) { // 1000ms = 1 second
-      HAL_GPIO_TogglePin(LED2_GPIO_Port, LED2_Pin); // Toggle LED2 for heartbeat
-      modbus_heartbeat = 0;
-      
-      // Update test data every second
-      test_counter++;
-      modbus_write_register(0x0001, 45 + (test_counter % 10)); // Simulate motor speed change
-      modbus_write_register(0x0011, 55 + (test_counter % 15)); // Simulate motor 2 speed change
-      
-      // Update system status
-      modbus_write_register(0x0022, 0x0001 | (test_counter & 0x000F)); // FIXED: Correct address
-      
-      // Debug: Print register values every 5 seconds
-      if (test_counter % 5 == 0) {
-        // Read some registers to verify they're working
-        uint16_t m1_target = modbus_read_register(0x0000);
-        uint16_t m1_current = modbus_read_register(0x0001);
-        uint16_t system_status = modbus_read_register(0x0022); // FIXED: Correct address
-        
-        // If registers are readable, blink LED3 quickly
-        if (m1_target == 50 && m1_current > 0) {
-          HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-          osDelay(50);
-          HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-        }
-      }
-    }
-    
-    // Debug: Check if any modbus data was received (simple check)
-    static uint16_t last_m1_target = 0;
-    static uint16_t last_m2_target = 0;
-    
-    uint16_t current_m1_target = modbus_read_register(0x0000);
-    uint16_t current_m2_target = modbus_read_register(0x0010);
-    
-    // If motor targets changed, blink LED3 to show modbus write worked
-    if (current_m1_target != last_m1_target) {
-      HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-      osDelay(100);
-      HAL_GPIO_TogglePin(LED3_GPIO_Port, LED3_Pin);
-      last_m1_target = current_m1_target;
-    }
-    
-    if (current_m2_target != last_m2_target) {
-      HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
-      osDelay(100);
-      HAL_GPIO_TogglePin(LED4_GPIO_Port, LED4_Pin);
-      last_m2_target = current_m2_target;
-    }
-    
-    osDelay(1);
+    // Heartbeat: LED2 dao moi giay
+    HAL_GPIO_TogglePin(LED2_GPIO_Port, LED2_Pin);
+
+    tick += 1000;
+    osDelayUntil(tick);
   }
   /* USER CODE END StartTask04 */
 }
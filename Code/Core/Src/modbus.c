@@ -9,21 +9,21 @@
 #include "modbus_crc.h"
 #include "modbus_config.h"
 #include "modbus_port.h"
+#include "ModbusMap.h"
 #include <string.h>
 #include <stdbool.h>
 
 static uint8_t modbus_rx_buffer[MODBUS_BUFFER_SIZE];
 static uint16_t modbus_rx_index = 0;
 
-// Bộ thanh ghi ảo đơn giản
-static uint16_t holding_registers[MODBUS_MAX_REGISTERS];
+// Holding registers nằm trực tiếp trong g_modbus_data (địa chỉ == offset word)
+static uint16_t * const holding_registers = (uint16_t *)&g_modbus_data;
 
 static void modbus_send_response(uint8_t *data, uint16_t len);
 static void modbus_process_frame(void);
 
 void modbus_init(void) {
     modbus_port_init();
-    memset(holding_registers, 0, sizeof(holding_registers));
 }
 
 void modbus_receive_byte(uint8_t byte) {
@@ -67,28 +67,13 @@ void modbus_write_register(uint16_t reg_addr, uint16_t value) {
 }
 
 // Validation function cho register addresses
+// Ban do register lien tuc tu 0x0000 den TOTAL_REG_COUNT (o reserved doc ra 0,
+// o chi doc do firmware cap nhat lai) nen chi can kiem tra bien
 static bool modbus_validate_register_range(uint16_t start_addr, uint16_t quantity) {
-    // Kiểm tra bounds
-    if (start_addr >= MODBUS_MAX_REGISTERS || 
-        quantity == 0 || 
-        quantity > MODBUS_MAX_REGISTERS ||
-        start_addr + quantity > MODBUS_MAX_REGISTERS) {
-        return false;
-    }
-    
-    // Kiểm tra register ranges cho motor control
-    if (start_addr >= 0x0000 && start_addr < 0x0010) {
-        // Motor 1 registers - OK
-        return true;
-    } else if (start_addr >= 0x0010 && start_addr < 0x0020) {
-        // Motor 2 registers - OK  
-        return true;
-    } else if (start_addr >= 0x00F0 && start_addr < 0x0100) {
-        // System registers - OK
-        return true;
-    }
-    
-    return false;
+    return start_addr < MODBUS_MAX_REGISTERS &&
+           quantity != 0 &&
+           quantity <= MODBUS_MAX_QUANTITY &&
+           (uint32_t)start_addr + quantity <= MODBUS_MAX_REGISTERS;
 }
 
 static void modbus_process_frame(void) {
@@ -44,7 +44,7 @@ void modbus_port_init(void) {
     // KHÔNG gọi lại HAL_TIM_Base_Init vì đã được gọi trong main.c  
     // HAL_TIM_Base_Init(&htim2);
     
-    // Timer đã được config đúng trong main.c với Period = 4000, Prescaler = 71
+    // Timer đã được config trong main.c: 1 MHz, Period = t3.5 (Timing_GetModbusT35Us)
     // Clear timer counter
     __HAL_TIM_SET_COUNTER(&htim2, 0);
     
@@ -0,0 +1,29 @@
+/*
+ * main.h (host)
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+#ifndef TEST_STUB_MAIN_H_
+#define TEST_STUB_MAIN_H_
+
+#include <stdint.h>
+
+/*
+ * Thay cho main.h cua CubeMX khi build module firmware tren may host:
+ * chi giu cac intrinsic critical section ma module thuan tinh toan dung.
+ */
+
+static inline uint32_t __get_PRIMASK(void) {
+    return 0U;
+}
+
+static inline void __disable_irq(void) {
+}
+
+static inline void __set_PRIMASK(uint32_t primask) {
+    (void)primask;
+}
+
+#endif /* TEST_STUB_MAIN_H_ */
@@ -0,0 +1,137 @@
+/*
+ * test_backemf.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+/*
+ * Mo phong dong co DC (R, L, Ke, J, ma sat nhot) chay tren may host, cap
+ * duty / dong do cho BackEMF_Update() dung nhu ISR CurrentSense va so toc do
+ * uoc luong voi toc do that cua mo hinh sau moi lan doi lenh / tai.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "BackEMF.h"
+#include "Config.h"
+
+#define PLANT_SUBSTEPS      20                      // buoc tich phan moi tick nhanh
+#define PLANT_VBUS_MV       12000U
+#define PLANT_R_OHM         2.0
+#define PLANT_L_H           1.0e-3
+#define PLANT_KE_UV_RPM     2000U                   // 2 mV / RPM
+#define PLANT_J             2.0e-5                  // kg m^2
+#define PLANT_B             2.0e-6                  // N m s / rad
+#define ADC_LSB_MA          8                       // ACS712 5A qua ADC 12 bit ~ 8 mA
+
+#define RPM_PER_RAD_S       (60.0 / (2.0 * M_PI))
+
+typedef struct {
+    double current;         // A
+    double omega;           // rad/s
+} Plant_t;
+
+typedef struct {
+    const char *name;
+    double   duration_s;
+    int32_t  duty;          // Q15
+    double   load_nm;
+} Phase_t;
+
+static const Phase_t phases[] = {
+    { "start 50 %",     0.5,  16384, 0.0   },
+    { "load 20 mNm",    0.5,  16384, 0.02  },
+    { "duty 20 %",      0.5,   6554, 0.02  },
+    { "reverse -60 %",  0.6, -19661, -0.02 },
+    { "no load",        0.5, -19661, 0.0   },
+};
+
+static uint32_t noise_state = 12345U;
+
+// Nhieu ADC +-1 LSB (LCG, lap lai duoc)
+static int32_t adc_noise(void) {
+    noise_state = noise_state * 1103515245U + 12345U;
+    return (int32_t)((noise_state >> 16) % 3U) - 1;
+}
+
+static void plant_step(Plant_t *p, double v, double load_nm, double dt) {
+    double ke = PLANT_KE_UV_RPM * 1.0e-6 * RPM_PER_RAD_S;  // V s / rad = Kt
+    double di = (v - p->current * PLANT_R_OHM - ke * p->omega) / PLANT_L_H;
+    double dw = (ke * p->current - PLANT_B * p->omega - load_nm) / PLANT_J;
+    p->current += di * dt;
+    p->omega += dw * dt;
+}
+
+static int32_t sample_current_ma(const Plant_t *p) {
+    int32_t lsb = (int32_t)lround(p->current * 1000.0 / ADC_LSB_MA) + adc_noise();
+    return lsb * ADC_LSB_MA;
+}
+
+int main(void) {
+    const double dt = 1.0 / ((double)CONFIG_CURRENT_LOOP_HZ * PLANT_SUBSTEPS);
+    const uint32_t settle_ticks = CONFIG_CURRENT_LOOP_HZ / 5U;     // 200 ms
+    BackEMF_Params_t params = {
+        .r_mohm = (uint16_t)(PLANT_R_OHM * 1000.0),
+        .l_uh = (uint16_t)(PLANT_L_H * 1.0e6),
+        .ke_uv_per_rpm = PLANT_KE_UV_RPM,
+        .vbus_mv = PLANT_VBUS_MV,
+    };
+    Plant_t plant = { 0.0, 0.0 };
+    int failures = 0;
+
+    BackEMF_Configure(0, &params, CONFIG_CURRENT_LOOP_HZ);
+    if (!BackEMF_IsEnabled(0)) {
+        printf("FAIL: estimator not enabled\n");
+        return EXIT_FAILURE;
+    }
+
+    for (size_t i = 0; i < sizeof(phases) / sizeof(phases[0]); i++) {
+        const Phase_t *ph = &phases[i];
+        uint32_t ticks = (uint32_t)(ph->duration_s * CONFIG_CURRENT_LOOP_HZ);
+        double v = (double)ph->duty * PLANT_VBUS_MV / 32768.0 / 1000.0;
+        double max_err = 0.0;
+        double rpm = 0.0;
+
+        for (uint32_t t = 0; t < ticks; t++) {
+            for (int s = 0; s < PLANT_SUBSTEPS; s++) {
+                plant_step(&plant, v, ph->load_nm, dt);
+            }
+            BackEMF_Update(0, ph->duty, sample_current_ma(&plant));
+
+            if (t >= settle_ticks) {
+                rpm = plant.omega * RPM_PER_RAD_S;
+                double err = fabs(BackEMF_GetSpeed(0) - rpm);
+                if (err > max_err) {
+                    max_err = err;
+                }
+            }
+        }
+
+        // 2 % toc do + 20 RPM (loc Q8, luong tu hoa dong / Ke)
+        double limit = 0.02 * fabs(rpm) + 20.0;
+        bool ok = max_err <= limit;
+        printf("%-4s %-14s rpm %7.1f  est %6ld  max err %5.1f (limit %5.1f)\n",
+               ok ? "ok" : "FAIL", ph->name, rpm, (long)BackEMF_GetSpeed(0), max_err, limit);
+        if (!ok) {
+            failures++;
+        }
+    }
+
+    BackEMF_Reset(0);
+    if (BackEMF_GetSpeed(0) != 0) {
+        printf("FAIL: reset did not clear the estimate\n");
+        failures++;
+    }
+
+    params.ke_uv_per_rpm = 0U;
+    BackEMF_Configure(0, &params, CONFIG_CURRENT_LOOP_HZ);
+    if (BackEMF_IsEnabled(0)) {
+        printf("FAIL: Ke = 0 must disable the estimator\n");
+        failures++;
+    }
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,184 @@
+/*
+ * test_motorident.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+/*
+ * Phat lai chuoi thu nhan dang (buoc dien ap + doc len / xuong, cung lich voi
+ * MotorIdent_Step) tren mo hinh dong co co thong so biet truoc, ghi du lieu
+ * nhu firmware (mau nhanh, mau cham da chia, dong luong tu hoa theo ADC) roi
+ * kiem tra MotorIdent_Fit() tim lai dung R, L, Ke, J, Fv, Fc.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "MotorIdentFit.h"
+#include "Config.h"
+
+#define PLANT_SUBSTEPS      20                      // buoc tich phan moi tick nhanh
+#define PLANT_VBUS_MV       12000U
+#define STEP_DUTY           8192                    // 25 %
+#define ADC_LSB_MA          8                       // ACS712 5A qua ADC 12 bit ~ 8 mA
+
+/* Thong so that cua mo hinh (don vi register) */
+typedef struct {
+    const char *name;
+    double r_mohm;
+    double l_uh;
+    double ke_uv_per_rpm;
+    double j_ua_s_per_rpm;
+    double fv_ua_per_rpm;
+    double fc_ma;
+} Motor_t;
+
+static const Motor_t motors[] = {
+    { "small 12 V",  2000.0, 1000.0, 2000.0, 110.0, 11.0, 50.0 },
+    { "geared 12 V",  800.0, 2500.0, 4000.0, 900.0, 40.0, 150.0 },
+};
+
+typedef struct {
+    double current;         // mA
+    double speed;           // RPM
+} Plant_t;
+
+static int16_t fast_buffer[CONFIG_IDENT_FAST_SAMPLES];
+static MotorIdent_Sample_t slow_buffer[CONFIG_IDENT_SLOW_SAMPLES];
+static uint32_t noise_state = 2024U;
+
+// Nhieu ADC +-1 LSB (LCG, lap lai duoc)
+static int32_t adc_noise(void) {
+    noise_state = noise_state * 1103515245U + 12345U;
+    return (int32_t)((noise_state >> 16) % 3U) - 1;
+}
+
+static int16_t sample_current_ma(const Plant_t *p) {
+    return (int16_t)((lround(p->current / ADC_LSB_MA) + adc_noise()) * ADC_LSB_MA);
+}
+
+// V = R*I + L*dI/dt + Ke*w ; I = J*dw/dt + Fv*w + Fc*sign(w)
+static void plant_step(const Motor_t *m, Plant_t *p, int32_t duty, double dt) {
+    double v = (double)duty * PLANT_VBUS_MV / 32768.0;                         // mV
+    double di = (v - p->current * m->r_mohm / 1000.0 - p->speed * m->ke_uv_per_rpm / 1000.0) /
+                (m->l_uh / 1.0e6);
+    double drive = p->current - p->speed * m->fv_ua_per_rpm / 1000.0;
+    if (p->speed > 0.0) {
+        drive -= m->fc_ma;
+    } else if (p->speed < 0.0) {
+        drive += m->fc_ma;
+    } else if (fabs(drive) <= m->fc_ma) {
+        drive = 0.0;                                    // ma sat tinh giu roto
+    } else {
+        drive -= (drive > 0.0) ? m->fc_ma : -m->fc_ma;
+    }
+    p->current += di * dt;
+    p->speed += drive / (m->j_ua_s_per_rpm / 1000.0) * dt;
+}
+
+// Lich duty giong MotorIdent_Step(): buoc -> doc len 2x -> doc xuong ve buoc
+static int32_t ident_duty(uint32_t ms) {
+    if (ms < CONFIG_IDENT_STEP_MS) {
+        return STEP_DUTY;
+    }
+    if (ms < CONFIG_IDENT_STEP_MS + CONFIG_IDENT_RAMP_MS) {
+        return STEP_DUTY + (int32_t)(((int64_t)STEP_DUTY * (ms - CONFIG_IDENT_STEP_MS)) / CONFIG_IDENT_RAMP_MS);
+    }
+    return 2 * STEP_DUTY - (int32_t)(((int64_t)STEP_DUTY *
+           (ms - CONFIG_IDENT_STEP_MS - CONFIG_IDENT_RAMP_MS)) / CONFIG_IDENT_RAMP_MS);
+}
+
+static int check(const char *name, double got, double want, double tolerance) {
+    double err = fabs(got - want) / want;
+    bool ok = err <= tolerance;
+    printf("%-4s %-3s got %8.1f  true %8.1f  err %5.1f %% (limit %4.1f %%)\n",
+           ok ? "ok" : "FAIL", name, got, want, err * 100.0, tolerance * 100.0);
+    return ok ? 0 : 1;
+}
+
+static int run_motor(const Motor_t *m) {
+    const uint32_t fast_per_ms = CONFIG_CURRENT_LOOP_HZ / CONFIG_CONTROL_LOOP_HZ;
+    const double dt = 1.0 / ((double)CONFIG_CURRENT_LOOP_HZ * PLANT_SUBSTEPS);
+    const uint32_t total_ms = CONFIG_IDENT_STEP_MS + 2U * CONFIG_IDENT_RAMP_MS;
+    Plant_t plant = { 0.0, 0.0 };
+    uint16_t fast_count = 0;
+    uint16_t slow_count = 0;
+    int32_t prev_duty = 0;
+    MotorIdent_Result_t res;
+    int failures = 0;
+
+    // Mau nhanh 0 lay truoc khi buoc co hieu luc (ISR chay truoc task)
+    fast_buffer[fast_count++] = sample_current_ma(&plant);
+
+    for (uint32_t ms = 0; ms < total_ms; ms++) {
+        int32_t duty = ident_duty(ms);
+
+        if ((ms % CONFIG_IDENT_DECIMATION) == 0U && slow_count < CONFIG_IDENT_SLOW_SAMPLES) {
+            MotorIdent_Sample_t *s = &slow_buffer[slow_count++];
+            s->duty = (int16_t)prev_duty;
+            s->current_ma = sample_current_ma(&plant);
+            s->speed_rpm = (int16_t)lround(plant.speed);
+        }
+        prev_duty = duty;
+
+        for (uint32_t f = 0; f < fast_per_ms; f++) {
+            for (int s = 0; s < PLANT_SUBSTEPS; s++) {
+                plant_step(m, &plant, duty, dt);
+            }
+            if (fast_count < CONFIG_IDENT_FAST_SAMPLES) {
+                fast_buffer[fast_count++] = sample_current_ma(&plant);
+            }
+        }
+    }
+
+    MotorIdent_Capture_t cap = {
+        .fast = fast_buffer,
+        .fast_count = fast_count,
+        .fast_hz = CONFIG_CURRENT_LOOP_HZ,
+        .slow = slow_buffer,
+        .slow_count = slow_count,
+        .slow_period_ms = CONFIG_IDENT_DECIMATION,
+        .step_duty = STEP_DUTY,
+        .vbus_mv = PLANT_VBUS_MV,
+        .has_speed = true,
+    };
+    printf("-- %s\n", m->name);
+    if (!MotorIdent_Fit(&cap, &res)) {
+        printf("FAIL: fit rejected the capture\n");
+        return 1;
+    }
+    failures += check("R", res.r_mohm, m->r_mohm, 0.05);
+    failures += check("L", res.l_uh, m->l_uh, 0.10);
+    failures += check("Ke", res.ke_uv_per_rpm, m->ke_uv_per_rpm, 0.03);
+    failures += check("J", res.j_ua_s_per_rpm, m->j_ua_s_per_rpm, 0.05);
+    failures += check("Fv", res.fv_ua_per_rpm, m->fv_ua_per_rpm, 0.10);
+    failures += check("Fc", res.fc_ma, m->fc_ma, 0.10);
+
+    // Khong co phan hoi toc do: chi R, L
+    cap.has_speed = false;
+    if (!MotorIdent_Fit(&cap, &res) || res.ke_uv_per_rpm != 0U || res.j_ua_s_per_rpm != 0U) {
+        printf("FAIL: fit without speed feedback must return R, L only\n");
+        failures++;
+    }
+
+    // Khong co kich thich: phai bao loi, khong tra ve so rac
+    cap.fast_count = 0;
+    cap.slow_count = 0;
+    if (MotorIdent_Fit(&cap, &res)) {
+        printf("FAIL: fit accepted an empty capture\n");
+        failures++;
+    }
+
+    return failures;
+}
+
+int main(void) {
+    int failures = 0;
+
+    for (size_t i = 0; i < sizeof(motors) / sizeof(motors[0]); i++) {
+        failures += run_motor(&motors[i]);
+    }
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
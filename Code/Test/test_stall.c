@@ -0,0 +1,105 @@
+/*
+ * test_stall.c
+ *
+ *  Created on: Oct 19, 2026
+ *      Author: ASUS
+ */
+
+/*
+ * Chay chuoi ket rotor -> cho thu lai (STALL_REACTION_RETRY) nhu _updateStall,
+ * voi ISR qua dong (analog watchdog, chung cho 2 motor) ghi
+ * MOTOR_ERR_OVERCURRENT vao ma loi o cac thoi diem khac nhau. Loi OCP khong
+ * duoc bi lan thu lai xoa hay bi STALL ghi de.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "Stall.h"
+#include "ModbusMap.h"
+#include "PWM.h"
+
+#define STALL_CURRENT_MA    2000
+#define RETRY_DELAY_MS      100U
+
+static const Stall_Params_t params = {
+    .current_ma = 1500,
+    .speed_rpm = 10,
+    .duty_pm = 500,
+    .time_ms = 50,
+    .retry_delay_ms = RETRY_DELAY_MS,
+    .retry_max = 3,
+};
+
+static int failures;
+
+static void expect(bool ok, const char *what) {
+    printf("%-4s %s\n", ok ? "ok" : "FAIL", what);
+    if (!ok) {
+        failures++;
+    }
+}
+
+// Dong lon, dung yen, duty 80 % den khi xac nhan ket; ghi loi nhu _updateStall
+static bool run_until_stall(uint16_t *error) {
+    for (uint32_t t = 0; t < 1000U; t++) {
+        if (Stall_Check(0, &params, STALL_CURRENT_MA, 0, (PWM_DUTY_MAX * 4) / 5)) {
+            if (!Stall_Latch(0, error)) {
+                return false;
+            }
+            Stall_StartBackoff(0, &params);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Dem tick den khi thu lai (hoac het thoi gian cho ma bi huy)
+static bool run_backoff(uint16_t *error, bool ocp_tripped, uint32_t ocp_at) {
+    for (uint32_t t = 0; t < 10U * RETRY_DELAY_MS; t++) {
+        if (t == ocp_at) {
+            *error = MOTOR_ERR_OVERCURRENT;
+        }
+        if (Stall_RetryDue(0, error, ocp_tripped && t >= ocp_at)) {
+            return true;
+        }
+        if (Stall_GetState(0) != STALL_STATE_BACKOFF) {
+            return false;
+        }
+    }
+    return false;
+}
+
+int main(void) {
+    uint16_t error = MOTOR_ERR_NONE;
+
+    // Thu lai binh thuong: STALL duoc xoa khi het thoi gian cho
+    Stall_Reset(0);
+    expect(run_until_stall(&error) && error == MOTOR_ERR_STALL &&
+           Stall_GetState(0) == STALL_STATE_BACKOFF, "stall latches and backs off");
+    expect(run_backoff(&error, false, UINT32_MAX) && error == MOTOR_ERR_NONE &&
+           Stall_GetState(0) == STALL_STATE_OK && Stall_GetRetries(0) == 1U,
+           "retry clears the stall");
+
+    // OCP trong luc cho: loi giu OVERCURRENT, khong thu lai
+    error = MOTOR_ERR_NONE;
+    expect(run_until_stall(&error), "second stall");
+    expect(!run_backoff(&error, true, RETRY_DELAY_MS / 2U), "OCP during back-off blocks the retry");
+    expect(error == MOTOR_ERR_OVERCURRENT, "OCP error survives the retry");
+    expect(Stall_GetState(0) == STALL_STATE_OK && Stall_GetRetries(0) == 0U,
+           "stall logic reset, waits for Reset_Error_Command");
+
+    // OCP da duoc nha (PWM con cat) nhung ma loi chua reset: van khong thu lai
+    error = MOTOR_ERR_NONE;
+    expect(run_until_stall(&error), "third stall");
+    expect(!run_backoff(&error, true, 0U) && error == MOTOR_ERR_OVERCURRENT,
+           "OCP tripped at the due tick blocks the retry");
+
+    // ISR dat OCP cung tick voi xac nhan ket: STALL khong ghi de
+    Stall_Reset(0);
+    error = MOTOR_ERR_OVERCURRENT;
+    expect(!run_until_stall(&error) && error == MOTOR_ERR_OVERCURRENT &&
+           Stall_GetState(0) == STALL_STATE_OK, "stall does not overwrite OCP");
+
+    return (failures == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
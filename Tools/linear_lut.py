@@ -0,0 +1,126 @@
+#!/usr/bin/env python3
+"""Build the LINEAR mode lookup table (REG_Mx_LIN_x) from a logged duty sweep.
+
+Log the sweep with the table disabled (Mx_Lin_Enable = 0) so that
+Mx_Linear_Input maps straight to duty: step Mx_Linear_Input slowly from 0 to
+1000, let the speed settle at each step, and record one CSV row per sample:
+
+    input,speed
+    0,0
+    20,0
+    40,35
+    ...
+
+`input` is Mx_Linear_Input (per-mille duty) and `speed` is Mx_Actual_Speed
+(RPM). Extra columns are ignored; the header names can be changed with
+--input-column / --speed-column.
+
+The tool finds the dead band (first duty that turns the motor) and, for each
+of the 17 uniform breakpoints, the duty that gives a proportional share of
+the top speed. It prints the register values to write, Mx_Lin_Deadband and
+Mx_Lin_Table[0..16], ready for one FC16 request each, then Mx_Lin_Enable = 1
+and a parameter save.
+
+    python3 linear_lut.py sweep.csv --motor 1
+"""
+
+import argparse
+import csv
+import sys
+
+LUT_SEGMENTS = 16
+LUT_POINTS = LUT_SEGMENTS + 1
+REG_LIN_BASE = {1: 0x0160, 2: 0x0180}
+REG_DEADBAND = 0x01
+REG_TABLE = 0x04
+
+
+def load_sweep(path, input_column, speed_column):
+    """Return [(duty_pm, |speed|)] averaged per duty and sorted by duty."""
+    sums = {}
+    with open(path, newline="") as f:
+        for row in csv.DictReader(f):
+            try:
+                duty = int(float(row[input_column]))
+                speed = abs(float(row[speed_column]))
+            except (KeyError, ValueError):
+                continue
+            if 0 <= duty <= 1000:
+                total, n = sums.get(duty, (0.0, 0))
+                sums[duty] = (total + speed, n + 1)
+    return [(d, t / n) for d, (t, n) in sorted(sums.items())]
+
+
+def monotonic(points):
+    """Clip measurement noise so that speed never falls as duty rises."""
+    out, top = [], 0.0
+    for duty, speed in points:
+        top = max(top, speed)
+        out.append((duty, top))
+    return out
+
+
+def duty_for_speed(points, speed):
+    """Smallest duty reaching `speed`, interpolated between sweep samples."""
+    for (d0, s0), (d1, s1) in zip(points, points[1:]):
+        if s1 >= speed:
+            if s1 == s0:
+                return float(d0)
+            return d0 + (d1 - d0) * (speed - s0) / (s1 - s0)
+    return float(points[-1][0])
+
+
+def build_table(points, threshold):
+    top = points[-1][1]
+    if top <= 0:
+        raise ValueError("the motor never turned during the sweep")
+    moving = threshold if threshold is not None else 0.02 * top
+    deadband = next((d for d, s in points if s > moving), None)
+    if deadband is None:
+        raise ValueError(f"threshold {moving:.0f} RPM is not below the top "
+                         f"measured speed {top:.0f} RPM")
+    # Duty that just starts the motor: last sample still below the threshold
+    deadband = max([d for d, s in points if d <= deadband and s <= moving] or [0])
+    span = 1000 - deadband
+
+    table, last = [], 0
+    for i in range(LUT_POINTS):
+        if i == 0:
+            value = 0
+        else:
+            duty = duty_for_speed(points, top * i / LUT_SEGMENTS)
+            value = round((duty - deadband) * 1000 / span) if span > 0 else 1000
+        value = min(1000, max(last, value))
+        table.append(value)
+        last = value
+    return deadband, table
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("sweep", help="CSV log of the duty sweep")
+    parser.add_argument("--motor", type=int, choices=(1, 2), default=1)
+    parser.add_argument("--input-column", default="input")
+    parser.add_argument("--speed-column", default="speed")
+    parser.add_argument("--threshold", type=float,
+                        help="speed (RPM) that counts as turning, default 2%% of top speed")
+    args = parser.parse_args()
+
+    points = monotonic(load_sweep(args.sweep, args.input_column, args.speed_column))
+    if len(points) < 2:
+        sys.exit("need at least two sweep points")
+    try:
+        deadband, table = build_table(points, args.threshold)
+    except ValueError as e:
+        sys.exit(str(e))
+
+    base = REG_LIN_BASE[args.motor]
+    print(f"# top speed {points[-1][1]:.0f} RPM, dead band {deadband} per-mille")
+    print(f"0x{base + REG_DEADBAND:04X}  M{args.motor}_Lin_Deadband = {deadband}")
+    print(f"0x{base + REG_TABLE:04X}  M{args.motor}_Lin_Table    = {', '.join(map(str, table))}")
+    for i, value in enumerate(table):
+        print(f"#   input {1000 * i // LUT_SEGMENTS:4d} -> table {value:4d}")
+
+
+if __name__ == "__main__":
+    main()